@@ -1,20 +1,51 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#define MAX_SIZE 100
+#include "../common/workload.h"
+#include "../common/instrument.h"
+#include "../common/report.h"
+
+#define INITIAL_CAPACITY 16
 
 // Structure to represent a Job
+// Job ids are indices: 0 -> 'A', 1 -> 'B' ... (numbers beyond 'Z')
 typedef struct {
-    char id;
+    int id;
     int priority;
 } Job;
 
-// Structure to represent the Max-Heap
+// Structure to represent the Max-Heap (grows on demand)
 typedef struct {
-    Job array[MAX_SIZE];
+    Job *array;
     int size;
+    int capacity;
 } MaxHeap;
 
+// Allocate an empty heap able to hold `capacity` jobs without growing
+void initHeap(MaxHeap *heap, int capacity) {
+    if (capacity < INITIAL_CAPACITY) capacity = INITIAL_CAPACITY;
+    heap->array = (Job *)malloc(capacity * sizeof(Job));
+    heap->size = 0;
+    heap->capacity = heap->array ? capacity : 0;
+}
+
+void freeHeap(MaxHeap *heap) {
+    free(heap->array);
+    heap->array = NULL;
+    heap->size = heap->capacity = 0;
+}
+
+// Quiet/batch mode writer (-q). NULL means narrative output.
+ReportWriter *batch = NULL;
+
+// Print a job id as a letter (A-Z) or as a number once letters run out
+void printJobId(int id) {
+    if (id >= 0 && id < 26)
+        printf("%c", 'A' + id);
+    else
+        printf("%d", id);
+}
+
 // Function to swap two jobs
 void swap(Job *a, Job *b) {
     Job temp = *a;
@@ -25,24 +56,36 @@ void swap(Job *a, Job *b) {
 // Function to maintain Max-Heap property (Sift Down)
 // Used during Build Heap and Delete
 void maxHeapify(MaxHeap *heap, int idx) {
-    int largest = idx;
-    int left = 2 * idx + 1;
-    int right = 2 * idx + 2;
+    int depth = 0; // Levels sifted, reported by the instrumentation
+
+    // Each iteration moves the element down one level
+    while (1) {
+        int largest = idx;
+        int left = 2 * idx + 1;
+        int right = 2 * idx + 2;
 
-    // Check if left child exists and is greater than root
-    if (left < heap->size && heap->array[left].priority > heap->array[largest].priority)
-        largest = left;
+        // Check if left child exists and is greater than root
+        if (left < heap->size && heap->array[left].priority > heap->array[largest].priority)
+            largest = left;
 
-    // Check if right child exists and is greater than largest so far
-    if (right < heap->size && heap->array[right].priority > heap->array[largest].priority)
-        largest = right;
+        // Check if right child exists and is greater than largest so far
+        if (right < heap->size && heap->array[right].priority > heap->array[largest].priority)
+            largest = right;
+
+        // Stop once the root of the sub-tree is the largest
+        if (largest == idx) break;
 
-    // If largest is not root
-    if (largest != idx) {
         swap(&heap->array[idx], &heap->array[largest]);
-        // Recursively heapify the affected sub-tree
-        maxHeapify(heap, largest);
+        INSTR_COUNT(heap_swaps, 1);
+        depth++;
+
+        // Continue in the affected sub-tree
+        idx = largest;
     }
+
+    INSTR_COUNT(sift_down_calls, 1);
+    INSTR_COUNT(sift_depth_total, depth);
+    INSTR_MAX(sift_depth_max, depth);
 }
 
 // Function to build Max-Heap from an arbitrary array
@@ -55,10 +98,16 @@ void buildMaxHeap(MaxHeap *heap) {
 }
 
 // Function to insert a new job (Bubble Up)
-void insertJob(MaxHeap *heap, char id, int priority) {
-    if (heap->size == MAX_SIZE) {
-        printf("Heap Overflow\n");
-        return;
+void insertJob(MaxHeap *heap, int id, int priority) {
+    if (heap->size == heap->capacity) {
+        int capacity = heap->capacity * 2;
+        Job *grown = (Job *)realloc(heap->array, capacity * sizeof(Job));
+        if (!grown) {
+            reportMessage(batch, "Heap Overflow\n");
+            return;
+        }
+        heap->array = grown;
+        heap->capacity = capacity;
     }
 
     // Insert at the end
@@ -67,11 +116,16 @@ void insertJob(MaxHeap *heap, char id, int priority) {
     heap->array[i].priority = priority;
     heap->size++;
 
-    printf("\n[Operation] Inserting Job %c (Priority %d)...\n", id, priority);
+    if (!batch) {
+        printf("\n[Operation] Inserting Job ");
+        printJobId(id);
+        printf(" (Priority %d)...\n", priority);
+    }
 
     // Fix the max heap property if it is violated (Bubble Up)
     while (i != 0 && heap->array[(i - 1) / 2].priority < heap->array[i].priority) {
         swap(&heap->array[i], &heap->array[(i - 1) / 2]);
+        INSTR_COUNT(heap_swaps, 1);
         i = (i - 1) / 2;
     }
 }
@@ -80,8 +134,11 @@ void insertJob(MaxHeap *heap, char id, int priority) {
 void deleteRoot(MaxHeap *heap) {
     if (heap->size <= 0) return;
 
-    printf("\n[Operation] Deleting Root Job %c (Priority %d)...\n", 
-           heap->array[0].id, heap->array[0].priority);
+    if (!batch) {
+        printf("\n[Operation] Deleting Root Job ");
+        printJobId(heap->array[0].id);
+        printf(" (Priority %d)...\n", heap->array[0].priority);
+    }
 
     // Replace root with last element
     heap->array[0] = heap->array[heap->size - 1];
@@ -91,49 +148,103 @@ void deleteRoot(MaxHeap *heap) {
     maxHeapify(heap, 0);
 }
 
-// Helper to print the heap
+// Helper to print the heap (narrative mode only)
 void printHeap(MaxHeap *heap) {
+    if (batch) return;
     printf("Current Heap State: ");
-    for (int i = 0; i < heap->size; ++i)
-        printf("[%c: %d] ", heap->array[i].id, heap->array[i].priority);
+    for (int i = 0; i < heap->size; ++i) {
+        printf("[");
+        printJobId(heap->array[i].id);
+        printf(": %d] ", heap->array[i].priority);
+    }
     printf("\n");
 }
 
-int main() {
+// Quiet mode: one record per heap slot, in array order
+void writeHeapRecords(MaxHeap *heap) {
+    for (int i = 0; i < heap->size; ++i) {
+        reportBegin(batch, "heap");
+        reportInt(batch, "index", i);
+        reportInt(batch, "id", heap->array[i].id);
+        reportInt(batch, "priority", heap->array[i].priority);
+        reportEnd(batch);
+    }
+}
+
+// Usage: question1 [-q] [priorities.txt]
+// Without a file the built-in job list is used.
+// -q: no narrative; the final heap is written as JSON lines to stdout.
+int main(int argc, char *argv[]) {
     MaxHeap heap;
-    heap.size = 0;
+    ReportWriter writer;
+    INSTR_INIT("question1");
+
+    if (reportTakeQuietFlag(&argc, argv)) {
+        reportOpen(&writer, 1);
+        batch = &writer;
+    }
 
     // Initial Data
-    int priorities[] = {42, 17, 93, 28, 65, 81, 54, 60, 99, 73, 88};
-    int n = sizeof(priorities) / sizeof(priorities[0]);
+    int defaultPriorities[] = {42, 17, 93, 28, 65, 81, 54, 60, 99, 73, 88};
+    int *priorities = defaultPriorities;
+    int n = sizeof(defaultPriorities) / sizeof(defaultPriorities[0]);
+
+    INSTR_TIMER_BEGIN(load);
+    if (argc > 1 && loadPriorityStream(argv[1], &priorities, &n) != 0) return 1;
+    INSTR_TIMER_END(load);
+
+    // Room for everything plus the urgent job, so the insert never reallocates
+    initHeap(&heap, n + 1);
+    if (heap.capacity == 0) {
+        reportMessage(batch, "Heap Overflow\n");
+        return 1;
+    }
 
     // 1. Assign unique identifiers and load into array
-    printf("--- Initial Array (Binary Tree Representation) ---\n");
+    if (!batch) printf("--- Initial Array (Binary Tree Representation) ---\n");
+    int maxPriority = 0;
     for (int i = 0; i < n; i++) {
         heap.array[i].priority = priorities[i];
-        heap.array[i].id = 'A' + i; // Assign IDs A, B, C...
+        heap.array[i].id = i; // Assign IDs A, B, C...
+        if (priorities[i] > maxPriority) maxPriority = priorities[i];
     }
     heap.size = n;
     printHeap(&heap);
 
     // 2. Build Max-Heap
-    printf("\n--- Building Max-Heap ---\n");
+    if (!batch) printf("\n--- Building Max-Heap ---\n");
+    INSTR_TIMER_BEGIN(build);
     buildMaxHeap(&heap);
+    INSTR_TIMER_END(build);
     printHeap(&heap);
 
-    // 3. Insert Urgent Job (Priority 100)
-    // We'll use 'L' as the ID for the next job
-    insertJob(&heap, 'L', 100);
+    // 3. Insert Urgent Job (Priority 100, or above everything in a loaded stream)
+    // The next job gets the next id ('L' for the built-in list)
+    // No overflow: loadPriorityStream rejects INT_MAX, so there is always headroom
+    int urgent = maxPriority < 100 ? 100 : maxPriority + 1;
+    INSTR_TIMER_BEGIN(insert);
+    insertJob(&heap, n, urgent);
+    INSTR_TIMER_END(insert);
     printHeap(&heap);
 
-    // 4. Urgent Job Aborted: Remove Job with Priority 100
-    // Since it's a Max-Heap, 100 will be at the root (index 0)
-    if (heap.array[0].priority == 100) {
+    // 4. Urgent Job Aborted: Remove the urgent job
+    // Since it's a Max-Heap, it will be at the root (index 0)
+    if (heap.array[0].priority == urgent) {
+        INSTR_TIMER_BEGIN(delete);
         deleteRoot(&heap);
+        INSTR_TIMER_END(delete);
     } else {
-        printf("Error: Priority 100 is not at the root!\n");
+        reportMessage(batch, "Error: Priority %d is not at the root!\n", urgent);
     }
     printHeap(&heap);
 
-    return 0;
+    int rc = 0;
+    if (batch) {
+        writeHeapRecords(&heap);
+        rc = reportClose(batch) == 0 ? 0 : 1;
+    }
+
+    freeHeap(&heap);
+    if (priorities != defaultPriorities) free(priorities);
+    return rc;
 }
@@ -2,7 +2,12 @@
 #include <stdlib.h>
 #include <string.h>
 
-#define MAX_PASSENGERS 50
+#include "../common/workload.h"
+#include "../common/instrument.h"
+#include "../common/report.h"
+#include "../common/arena.h"
+
+#define INITIAL_CAPACITY 16
 
 // 1. Structure for Passenger
 typedef struct {
@@ -10,12 +15,30 @@ typedef struct {
     int riskScore;
 } Passenger;
 
-// Max-Heap Structure
+// Max-Heap Structure (grows on demand)
 typedef struct {
-    Passenger array[MAX_PASSENGERS];
+    Passenger *array;
     int size;
+    int capacity;
 } MaxHeap;
 
+// Quiet/batch mode writer (-q). NULL means narrative output.
+ReportWriter *batch = NULL;
+
+// Allocate an empty heap able to hold `capacity` passengers without growing
+void initHeap(MaxHeap *heap, int capacity) {
+    if (capacity < INITIAL_CAPACITY) capacity = INITIAL_CAPACITY;
+    heap->array = (Passenger *)malloc(capacity * sizeof(Passenger));
+    heap->size = 0;
+    heap->capacity = heap->array ? capacity : 0;
+}
+
+void freeHeap(MaxHeap *heap) {
+    free(heap->array);
+    heap->array = NULL;
+    heap->size = heap->capacity = 0;
+}
+
 void swap(Passenger *a, Passenger *b) {
     Passenger temp = *a;
     *a = *b;
@@ -24,20 +47,36 @@ void swap(Passenger *a, Passenger *b) {
 
 // Standard Sift-Down (Max-Heapify)
 void maxHeapify(MaxHeap *heap, int idx) {
-    int largest = idx;
-    int left = 2 * idx + 1;
-    int right = 2 * idx + 2;
+    int depth = 0; // Levels sifted, reported by the instrumentation
+
+    // Each iteration moves the element down one level
+    while (1) {
+        int largest = idx;
+        int left = 2 * idx + 1;
+        int right = 2 * idx + 2;
 
-    if (left < heap->size && heap->array[left].riskScore > heap->array[largest].riskScore)
-        largest = left;
+        // Check if left child exists and is greater than root
+        if (left < heap->size && heap->array[left].riskScore > heap->array[largest].riskScore)
+            largest = left;
 
-    if (right < heap->size && heap->array[right].riskScore > heap->array[largest].riskScore)
-        largest = right;
+        // Check if right child exists and is greater than largest so far
+        if (right < heap->size && heap->array[right].riskScore > heap->array[largest].riskScore)
+            largest = right;
+
+        // Stop once the root of the sub-tree is the largest
+        if (largest == idx) break;
 
-    if (largest != idx) {
         swap(&heap->array[idx], &heap->array[largest]);
-        maxHeapify(heap, largest);
+        INSTR_COUNT(heap_swaps, 1);
+        depth++;
+
+        // Continue in the affected sub-tree
+        idx = largest;
     }
+
+    INSTR_COUNT(sift_down_calls, 1);
+    INSTR_COUNT(sift_depth_total, depth);
+    INSTR_MAX(sift_depth_max, depth);
 }
 
 // Build Heap (Rearrange array)
@@ -49,21 +88,28 @@ void buildMaxHeap(MaxHeap *heap) {
 
 // Insert a new passenger (Bubble Up)
 void insertPassenger(MaxHeap *heap, char *name, int risk) {
-    if (heap->size == MAX_PASSENGERS) {
-        printf("System Full!\n");
-        return;
+    if (heap->size == heap->capacity) {
+        int capacity = heap->capacity * 2;
+        Passenger *grown = (Passenger *)realloc(heap->array, capacity * sizeof(Passenger));
+        if (!grown) {
+            reportMessage(batch, "System Full!\n");
+            return;
+        }
+        heap->array = grown;
+        heap->capacity = capacity;
     }
 
     int i = heap->size;
-    strcpy(heap->array[i].name, name);
+    snprintf(heap->array[i].name, sizeof(heap->array[i].name), "%s", name);
     heap->array[i].riskScore = risk;
     heap->size++;
 
-    printf("\n[Insert] Adding %s (Risk: %d)...\n", name, risk);
+    if (!batch) printf("\n[Insert] Adding %s (Risk: %d)...\n", name, risk);
 
     // Bubble up
     while (i != 0 && heap->array[(i - 1) / 2].riskScore < heap->array[i].riskScore) {
         swap(&heap->array[i], &heap->array[(i - 1) / 2]);
+        INSTR_COUNT(heap_swaps, 1);
         i = (i - 1) / 2;
     }
 }
@@ -99,11 +145,11 @@ void deleteByScore(MaxHeap *heap, int targetScore) {
     }
 
     if (!found) {
-        printf("Passenger with risk %d not found.\n", targetScore);
+        reportMessage(batch, "Passenger with risk %d not found.\n", targetScore);
         return;
     }
 
-    printf("\n[Delete] Removing passenger with Risk %d...\n", targetScore);
+    if (!batch) printf("\n[Delete] Removing passenger with Risk %d...\n", targetScore);
 
     // Swap with last element
     swap(&heap->array[i], &heap->array[heap->size - 1]);
@@ -115,27 +161,100 @@ void deleteByScore(MaxHeap *heap, int targetScore) {
     maxHeapify(heap, i);
 }
 
-// Helper to display current queue
+// Helper to display current queue (narrative mode only)
 void printQueue(MaxHeap *heap) {
+    if (batch) return;
     printf("Current Priority Queue (Root is highest risk): \n");
     if(heap->size == 0) printf("  [Empty]\n");
     for (int i = 0; i < heap->size; ++i)
         printf("  %d. %s (Risk: %d)\n", i, heap->array[i].name, heap->array[i].riskScore);
 }
 
+// Candidate queue for showProcessingOrder: a Max-Heap of *indices* into the
+// passenger heap, keyed on their risk scores
+void pushCandidate(const MaxHeap *heap, int *cand, int *count, int idx) {
+    int i = (*count)++;
+    while (i != 0 && heap->array[cand[(i - 1) / 2]].riskScore < heap->array[idx].riskScore) {
+        cand[i] = cand[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    cand[i] = idx;
+}
+
+int popCandidate(const MaxHeap *heap, int *cand, int *count) {
+    int top = cand[0];
+    int last = cand[--(*count)];
+    int i = 0;
+    while (1) {
+        int largest = 2 * i + 1;
+        if (largest >= *count) break;
+        if (largest + 1 < *count &&
+            heap->array[cand[largest + 1]].riskScore > heap->array[cand[largest]].riskScore)
+            largest++;
+        if (heap->array[cand[largest]].riskScore <= heap->array[last].riskScore) break;
+        cand[i] = cand[largest];
+        i = largest;
+    }
+    if (*count > 0) cand[i] = last;
+    return top;
+}
+
 // Helper to simulate full extraction order without destroying original heap
-void showProcessingOrder(MaxHeap heapCopy) {
-    printf("\n--- Simulated Processing Order (Highest to Lowest) ---\n");
-    while (heapCopy.size > 0) {
-        Passenger p = extractMax(&heapCopy);
-        printf("Processing: %s (Risk: %d)\n", p.name, p.riskScore);
+// Instead of copying the heap and extracting from the copy, walk the original
+// best-first: the next passenger is always the highest-risk child of someone
+// already processed. Only int indices move; scratch comes from the arena.
+void showProcessingOrder(const MaxHeap *heap, Arena *scratch) {
+    int *cand = (int *)arenaAlloc(scratch, (heap->size + 1) * sizeof(int));
+    if (!cand) scratchOutOfMemory("processing-order candidates");
+    int count = 0;
+    if (heap->size > 0) pushCandidate(heap, cand, &count, 0);
+
+    if (!batch) printf("\n--- Simulated Processing Order (Highest to Lowest) ---\n");
+    for (int rank = 0; count > 0; rank++) {
+        int idx = popCandidate(heap, cand, &count);
+        const Passenger *p = &heap->array[idx];
+        if (batch) {
+            reportBegin(batch, "processing");
+            reportInt(batch, "rank", rank);
+            reportString(batch, "name", p->name);
+            reportInt(batch, "risk", p->riskScore);
+            reportEnd(batch);
+        } else {
+            printf("Processing: %s (Risk: %d)\n", p->name, p->riskScore);
+        }
+
+        // Children of a processed passenger become candidates
+        if (2 * idx + 1 < heap->size) pushCandidate(heap, cand, &count, 2 * idx + 1);
+        if (2 * idx + 2 < heap->size) pushCandidate(heap, cand, &count, 2 * idx + 2);
     }
-    printf("------------------------------------------------------\n");
+    if (!batch) printf("------------------------------------------------------\n");
 }
 
-int main() {
+// Quiet mode: one record per queue slot, in array order
+void writeQueueRecords(MaxHeap *heap) {
+    for (int i = 0; i < heap->size; ++i) {
+        reportBegin(batch, "queue");
+        reportInt(batch, "index", i);
+        reportString(batch, "name", heap->array[i].name);
+        reportInt(batch, "risk", heap->array[i].riskScore);
+        reportEnd(batch);
+    }
+}
+
+// Usage: question2 [-q] [--repeat N] [risk_scores.txt]
+// Without a file the built-in passenger list is used.
+// Passengers loaded from a file are named P0, P1, ...
+// -q: no narrative; processing order and final queue are written as JSON lines.
+// --repeat: show the processing order N times on one scratch arena (steady-state check).
+int main(int argc, char *argv[]) {
     MaxHeap heap;
-    heap.size = 0;
+    ReportWriter writer;
+    INSTR_INIT("question2");
+
+    if (reportTakeQuietFlag(&argc, argv)) {
+        reportOpen(&writer, 1);
+        batch = &writer;
+    }
 
     // 1. Initial Data (Name, Risk Score)
     // We manually add them to the array first, then build heap
@@ -144,39 +263,94 @@ int main() {
         {"Fatima", 90}, {"Noah", 45}, {"Sofia", 70}
     };
     int n = 6;
+    int *scores = NULL;
 
+    const char *scorePath = NULL;
+    int repeat = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = atoi(argv[++i]);
+        else
+            scorePath = argv[i];
+    }
+    if (repeat < 1) repeat = 1;
+
+    INSTR_TIMER_BEGIN(load);
+    if (scorePath && loadPriorityStream(scorePath, &scores, &n) != 0) return 1;
+    INSTR_TIMER_END(load);
+
+    // Room for everything plus the new passenger
+    initHeap(&heap, n + 1);
+    if (heap.capacity == 0) {
+        reportMessage(batch, "System Full!\n");
+        return 1;
+    }
+
+    int maxScore = 0;
     for(int i=0; i<n; i++) {
-        strcpy(heap.array[i].name, initialData[i].n);
-        heap.array[i].riskScore = initialData[i].r;
+        if (scores) {
+            snprintf(heap.array[i].name, sizeof(heap.array[i].name), "P%d", i);
+            heap.array[i].riskScore = scores[i];
+        } else {
+            strcpy(heap.array[i].name, initialData[i].n);
+            heap.array[i].riskScore = initialData[i].r;
+        }
+        if (heap.array[i].riskScore > maxScore) maxScore = heap.array[i].riskScore;
     }
     heap.size = n;
 
     // 2. Build Max Heap
-    printf("--- Building Initial Heap ---\n");
+    if (!batch) printf("--- Building Initial Heap ---\n");
+    INSTR_TIMER_BEGIN(build);
     buildMaxHeap(&heap);
+    INSTR_TIMER_END(build);
     printQueue(&heap);
 
     // 3. Show Extraction Order (Priority Queue behavior)
-    // We pass a copy so we don't lose the data for the next steps
-    showProcessingOrder(heap); 
+    // The helper only reads the heap, so we don't lose the data for the next steps
+    INSTR_TIMER_BEGIN(processing_order);
+    Arena scratch;
+    arenaInit(&scratch, 0);
+    for (int run = 0; run < repeat; run++) {
+        long long allocsBefore = scratchSystemAllocs;
+        showProcessingOrder(&heap, &scratch); 
+        arenaReset(&scratch);
+        INSTR_SERIES(scratch_allocs_per_query, scratchSystemAllocs - allocsBefore);
+    }
+    arenaFree(&scratch);
+    INSTR_TIMER_END(processing_order);
 
-    // 4. New Passenger Arrives (Risk 98)
-    insertPassenger(&heap, "New_Passenger", 98);
+    // 4. New Passenger Arrives (Risk 98, or above everyone in a loaded list)
+    // No overflow: loadPriorityStream rejects INT_MAX, so there is always headroom
+    int newRisk = maxScore < 98 ? 98 : maxScore + 1;
+    INSTR_TIMER_BEGIN(insert);
+    insertPassenger(&heap, "New_Passenger", newRisk);
+    INSTR_TIMER_END(insert);
     printQueue(&heap);
 
     // Check if New_Passenger is at root (since 98 > 90)
-    if (heap.array[0].riskScore == 98) {
+    if (!batch && heap.array[0].riskScore == newRisk) {
         printf(">> Verification: New passenger is correctly at the top.\n");
     }
 
     // 5. Passenger cleared (Delete Risk 98)
-    deleteByScore(&heap, 98);
+    INSTR_TIMER_BEGIN(delete);
+    deleteByScore(&heap, newRisk);
+    INSTR_TIMER_END(delete);
     printQueue(&heap);
     
     // Check if previous max (Fatima, 90) returned to top
-    if (heap.array[0].riskScore == 90) {
+    if (!batch && heap.size > 0 && heap.array[0].riskScore == maxScore) {
         printf(">> Verification: Heap restored. Next highest risk is at top.\n");
     }
 
-    return 0;
+    int rc = 0;
+    if (batch) {
+        writeQueueRecords(&heap);
+        rc = reportClose(batch) == 0 ? 0 : 1;
+    }
+
+    freeHeap(&heap);
+    free(scores);
+    return rc;
 }
@@ -1,13 +1,14 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-// Number of Smart City Hubs (A, B, C, D, E, F, G)
-#define V 7 
+#include "../common/graph.h"
+#include "../common/instrument.h"
+#include "../common/report.h"
+#include "../common/arena.h"
 
-// Edge Structure
-typedef struct {
-    int src, dest, weight;
-} Edge;
+// Number of Smart City Hubs (A, B, C, D, E, F, G) in the built-in dataset
+#define V 7 
 
 // Subset structure for Union-Find (Cycle Detection)
 typedef struct {
@@ -16,16 +17,32 @@ typedef struct {
 } Subset;
 
 // Find function (path compression)
+// Two passes: walk up to the root, then point every node on the path at it
 int find(Subset subsets[], int i) {
-    if (subsets[i].parent != i)
-        subsets[i].parent = find(subsets, subsets[i].parent);
-    return subsets[i].parent;
+    int root = i;
+    int pathLength = 0;
+    while (subsets[root].parent != root) {
+        root = subsets[root].parent;
+        pathLength++;
+    }
+
+    while (subsets[i].parent != root) {
+        int next = subsets[i].parent;
+        subsets[i].parent = root;
+        i = next;
+    }
+
+    INSTR_COUNT(uf_find_calls, 1);
+    INSTR_COUNT(uf_find_path_total, pathLength);
+    INSTR_MAX(uf_find_path_max, pathLength);
+    return root;
 }
 
 // Union function (by rank)
-void Union(Subset subsets[], int x, int y) {
-    int xroot = find(subsets, x);
-    int yroot = find(subsets, y);
+// x and y must already be roots (the selection loop has just found them), so
+// they are linked directly instead of running find again
+void Union(Subset subsets[], int xroot, int yroot) {
+    INSTR_COUNT(uf_union_calls, 1);
 
     if (subsets[xroot].rank < subsets[yroot].rank)
         subsets[xroot].parent = yroot;
@@ -37,54 +54,94 @@ void Union(Subset subsets[], int x, int y) {
     }
 }
 
-// Comparator for sorting edges
-int compareEdges(const void* a, const void* b) {
-    Edge* a1 = (Edge*)a;
-    Edge* b1 = (Edge*)b;
-    return a1->weight - b1->weight;
-}
+// Quiet/batch mode writer (-q). NULL means narrative output.
+ReportWriter *batch = NULL;
+
+// Sort edges by weight (Smallest -> Largest), stable.
+// LSD radix sort, one pass per byte of the weight; bytes that are the same for
+// every edge are skipped (small weights usually need a single pass).
+// The ping-pong buffer comes from the scratch arena, so nothing is malloc'ed.
+void sortEdgesByWeight(Edge* edges, long long count, Arena* scratch) {
+    Edge* buffer = (Edge*)arenaAlloc(scratch, count * sizeof(Edge));
+    if (!buffer) scratchOutOfMemory("the edge sort buffer");
+    Edge* from = edges;
+    Edge* to = buffer;
+
+    for (int shift = 0; shift < 32; shift += 8) {
+        long long bucket[257] = {0};
+        for (long long i = 0; i < count; i++) {
+            // Flip the sign bit so negative weights sort first
+            unsigned key = (unsigned)from[i].weight ^ 0x80000000u;
+            bucket[((key >> shift) & 0xff) + 1]++;
+        }
+
+        int distinct = 0;
+        for (int b = 1; b <= 256; b++) distinct += bucket[b] != 0;
+        if (distinct <= 1) continue; // Every edge agrees on this byte
+
+        for (int b = 0; b < 256; b++) bucket[b + 1] += bucket[b];
+        for (long long i = 0; i < count; i++) {
+            unsigned key = (unsigned)from[i].weight ^ 0x80000000u;
+            to[bucket[(key >> shift) & 0xff]++] = from[i];
+        }
+
+        Edge* swapTemp = from;
+        from = to;
+        to = swapTemp;
+    }
 
-// Convert node index to Character (0->A, 1->B ...)
-char getNodeName(int index) {
-    return 'A' + index;
+    if (from != edges) memcpy(edges, from, count * sizeof(Edge));
 }
 
-void KruskalMST(int graph[V][V]) {
-    // 1. Gather all valid edges from the matrix
-    Edge edgeList[V * V]; 
-    int e_count = 0;
-
-    // Iterate upper triangle to avoid duplicates
-    for (int i = 0; i < V; i++) {
-        for (int j = i + 1; j < V; j++) {
-            if (graph[i][j] != 0) { // If there is a connection
-                edgeList[e_count].src = i;
-                edgeList[e_count].dest = j;
-                edgeList[e_count].weight = graph[i][j];
-                e_count++;
-            }
+// All scratch arrays come from `scratch`; the caller resets it between queries
+void KruskalMST(const CsrGraph *graph, Arena *scratch) {
+    int n = graph->numNodes;
+    char uName[16], vName[16];
+
+    // 1. Gather all edges from the CSR arrays
+    INSTR_TIMER_BEGIN(gather);
+    // Undirected graphs store each edge twice; keep only the u < v copy
+    Edge* edgeList = (Edge*)arenaAlloc(scratch, (graph->numArcs + 1) * sizeof(Edge));
+    if (!edgeList) scratchOutOfMemory("the edge list");
+    long long e_count = 0;
+
+    for (int u = 0; u < n; u++) {
+        for (int64_t k = graph->offsets[u]; k < graph->offsets[u + 1]; k++) {
+            int v = graph->targets[k];
+            if ((graph->flags & GRAPH_UNDIRECTED) && v <= u) continue;
+            edgeList[e_count].src = u;
+            edgeList[e_count].dest = v;
+            edgeList[e_count].weight = graph->weights ? graph->weights[k] : 1;
+            e_count++;
         }
     }
 
+    INSTR_TIMER_END(gather);
+
     // 2. Sort edges by weight (Smallest -> Largest)
-    qsort(edgeList, e_count, sizeof(Edge), compareEdges);
+    INSTR_TIMER_BEGIN(sort);
+    sortEdgesByWeight(edgeList, e_count, scratch);
+    INSTR_TIMER_END(sort);
 
     // 3. Initialize Union-Find
-    Subset* subsets = (Subset*)malloc(V * sizeof(Subset));
-    for (int v = 0; v < V; ++v) {
+    Subset* subsets = (Subset*)arenaAlloc(scratch, n * sizeof(Subset));
+    if (!subsets) scratchOutOfMemory("union-find subsets");
+    for (int v = 0; v < n; ++v) {
         subsets[v].parent = v;
         subsets[v].rank = 0;
     }
 
-    Edge results[V]; // MST will have V-1 edges
+    Edge* results = (Edge*)arenaAlloc(scratch, n * sizeof(Edge)); // MST will have n-1 edges
+    if (!results) scratchOutOfMemory("MST results");
     int resultIndex = 0;
-    int i = 0; 
-    int totalCost = 0;
+    long long i = 0; 
+    long long totalCost = 0;
 
-    printf("\n--- Kruskal's Algorithm Steps ---\n");
+    if (!batch) printf("\n--- Kruskal's Algorithm Steps ---\n");
+    INSTR_TIMER_BEGIN(select);
 
     // 4. Iterate and Select Edges
-    while (resultIndex < V - 1 && i < e_count) {
+    while (resultIndex < n - 1 && i < e_count) {
         Edge next_edge = edgeList[i++];
 
         int x = find(subsets, next_edge.src);
@@ -95,45 +152,125 @@ void KruskalMST(int graph[V][V]) {
             results[resultIndex++] = next_edge;
             totalCost += next_edge.weight;
             Union(subsets, x, y);
-            printf("Selected: %c -- %c (Cost: %d)\n", 
-                   getNodeName(next_edge.src), getNodeName(next_edge.dest), next_edge.weight);
-        } else {
-            printf("Skipped:  %c -- %c (Cost: %d) -> Forms Cycle\n", 
-                   getNodeName(next_edge.src), getNodeName(next_edge.dest), next_edge.weight);
+            if (!batch) {
+                graphNodeName(graph, next_edge.src, uName, sizeof(uName));
+                graphNodeName(graph, next_edge.dest, vName, sizeof(vName));
+                printf("Selected: %s -- %s (Cost: %d)\n", uName, vName, next_edge.weight);
+            }
+        } else if (!batch) {
+            graphNodeName(graph, next_edge.src, uName, sizeof(uName));
+            graphNodeName(graph, next_edge.dest, vName, sizeof(vName));
+            printf("Skipped:  %s -- %s (Cost: %d) -> Forms Cycle\n", uName, vName, next_edge.weight);
         }
     }
 
+    INSTR_TIMER_END(select);
+    INSTR_COUNT(edges_examined, i);
+
     // 5. Final Output
-    printf("\n-------------------------------------------------\n");
-    printf("FINAL MINIMUM SPANNING TREE (Fiber-Optic Network):\n");
-    printf("-------------------------------------------------\n");
-    for (int j = 0; j < resultIndex; j++) {
-        printf("Link: Hub %c <--> Hub %c  [Cost: $%dM]\n", 
-               getNodeName(results[j].src), getNodeName(results[j].dest), results[j].weight);
+    INSTR_TIMER_BEGIN(report);
+    if (batch) {
+        for (int j = 0; j < resultIndex; j++) {
+            reportBegin(batch, "mst_edge");
+            reportInt(batch, "src", results[j].src);
+            reportInt(batch, "dest", results[j].dest);
+            reportInt(batch, "weight", results[j].weight);
+            reportEnd(batch);
+        }
+        reportBegin(batch, "mst_total");
+        reportInt(batch, "nodes", n);
+        reportInt(batch, "edges", resultIndex);
+        reportInt(batch, "cost", totalCost);
+        reportBool(batch, "spanning", resultIndex == n - 1);
+        reportEnd(batch);
+    } else {
+        printf("\n-------------------------------------------------\n");
+        printf("FINAL MINIMUM SPANNING TREE (Fiber-Optic Network):\n");
+        printf("-------------------------------------------------\n");
+        for (int j = 0; j < resultIndex; j++) {
+            graphNodeName(graph, results[j].src, uName, sizeof(uName));
+            graphNodeName(graph, results[j].dest, vName, sizeof(vName));
+            printf("Link: Hub %s <--> Hub %s  [Cost: $%dM]\n", uName, vName, results[j].weight);
+        }
+        printf("-------------------------------------------------\n");
+        printf("TOTAL INSTALLATION COST: $%lld Million\n", totalCost);
+        printf("-------------------------------------------------\n");
     }
-    printf("-------------------------------------------------\n");
-    printf("TOTAL INSTALLATION COST: $%d Million\n", totalCost);
-    printf("-------------------------------------------------\n");
-
-    free(subsets);
+    INSTR_TIMER_END(report);
 }
 
-int main() {
-    // Mapping: A=0, B=1, C=2, D=3, E=4, F=5, G=6
-    // 0 indicates NO direct connection
-    int graph[V][V] = {
-        // A,  B,  C,  D,  E,  F,  G
-        {  0,  6,  0,  0,  0,  0,  0 }, // A: Connects to B(6). (A-D assumed 0/None)
-        {  6,  0, 11,  5,  0,  0,  0 }, // B: Connects to A(6), C(11), D(5)
-        {  0, 11,  0, 17,  0,  0, 25 }, // C: Connects to B(11), D(17), G(25)
-        {  0,  5, 17,  0, 22,  0,  0 }, // D: Connects to B(5), C(17), E(22). (D-F assumed 0)
-        {  0,  0,  0, 22,  0, 10,  0 }, // E: Connects to D(22), F(10)
-        {  0,  0,  0,  0, 10,  0, 22 }, // F: Connects to E(10), G(22)
-        {  0,  0, 25,  0,  0, 22,  0 }  // G: Connects to C(25), F(22)
-    };
-
-    printf("Calculating Fiber-Optic Network for %d Hubs...\n", V);
-    KruskalMST(graph);
-
-    return 0;
+// Usage: question3 [-q] [--repeat N] [graph.bin | edges.txt]
+// Without a file the built-in Smart City dataset is used.
+// -q: no per-step output; MST edges and total are written as JSON lines.
+// --repeat: run the query N times on one scratch arena (steady-state check).
+int main(int argc, char *argv[]) {
+    CsrGraph g;
+    ReportWriter writer;
+    INSTR_INIT("question3");
+
+    if (reportTakeQuietFlag(&argc, argv)) {
+        reportOpen(&writer, 1);
+        batch = &writer;
+    }
+
+    const char *graphPath = NULL;
+    int repeat = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = atoi(argv[++i]);
+        else
+            graphPath = argv[i];
+    }
+    if (repeat < 1) repeat = 1;
+
+    if (graphPath) {
+        INSTR_TIMER_BEGIN(load);
+        if (graphLoad(&g, graphPath, GRAPH_WEIGHTED | GRAPH_UNDIRECTED) != 0) return 1;
+        graphAdviseSequential(&g); // Edges are gathered row by row
+        INSTR_TIMER_END(load);
+    } else {
+        // Mapping: A=0, B=1, C=2, D=3, E=4, F=5, G=6
+        // 0 indicates NO direct connection
+        int graph[V][V] = {
+            // A,  B,  C,  D,  E,  F,  G
+            {  0,  6,  0,  0,  0,  0,  0 }, // A: Connects to B(6). (A-D assumed 0/None)
+            {  6,  0, 11,  5,  0,  0,  0 }, // B: Connects to A(6), C(11), D(5)
+            {  0, 11,  0, 17,  0,  0, 25 }, // C: Connects to B(11), D(17), G(25)
+            {  0,  5, 17,  0, 22,  0,  0 }, // D: Connects to B(5), C(17), E(22). (D-F assumed 0)
+            {  0,  0,  0, 22,  0, 10,  0 }, // E: Connects to D(22), F(10)
+            {  0,  0,  0,  0, 10,  0, 22 }, // F: Connects to E(10), G(22)
+            {  0,  0, 25,  0,  0, 22,  0 }  // G: Connects to C(25), F(22)
+        };
+
+        // Iterate upper triangle to avoid duplicates
+        Edge edges[V * V];
+        int e_count = 0;
+        for (int i = 0; i < V; i++) {
+            for (int j = i + 1; j < V; j++) {
+                if (graph[i][j] != 0) { // If there is a connection
+                    edges[e_count].src = i;
+                    edges[e_count].dest = j;
+                    edges[e_count].weight = graph[i][j];
+                    e_count++;
+                }
+            }
+        }
+        if (graphBuild(&g, V, edges, e_count, GRAPH_WEIGHTED | GRAPH_UNDIRECTED) != 0) return 1;
+    }
+
+    Arena scratch;
+    arenaInit(&scratch, 0);
+
+    for (int run = 0; run < repeat; run++) {
+        long long allocsBefore = scratchSystemAllocs;
+        if (!batch) printf("Calculating Fiber-Optic Network for %d Hubs...\n", g.numNodes);
+        KruskalMST(&g, &scratch);
+        arenaReset(&scratch);
+        INSTR_SERIES(scratch_allocs_per_query, scratchSystemAllocs - allocsBefore);
+    }
+
+    arenaFree(&scratch);
+    graphFree(&g);
+
+    return batch && reportClose(batch) != 0 ? 1 : 0;
 }
@@ -1,23 +1,34 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
-#define V 7  // Number of workstations (A-G)
-#define MAX_QUEUE 100
+#include "../common/graph.h"
+#include "../common/instrument.h"
+#include "../common/report.h"
+#include "../common/arena.h"
 
-// Graph Data (Adjacency Matrix)
-// 0 = A, 1 = B, 2 = C, 3 = D, 4 = E, 5 = F, 6 = G
-int adj[V][V];
+#define V 7  // Number of workstations (A-G) in the built-in dataset
+#define MAX_HORIZONS 32
+
+// Quiet/batch mode writer (-q). NULL means narrative output.
+ReportWriter *batch = NULL;
 
 // Queue Structure for BFS
+// Every node is enqueued at most once, so capacity = number of nodes
 typedef struct {
-    int items[MAX_QUEUE];
+    int* items;
+    int capacity;
     int front;
     int rear;
 } Queue;
 
 // Queue Operations
-void initQueue(Queue* q) {
+// Storage comes from the caller's scratch arena; there is nothing to free
+void initQueue(Queue* q, int capacity, Arena* scratch) {
+    q->items = (int*)arenaAlloc(scratch, capacity * sizeof(int));
+    if (!q->items) scratchOutOfMemory("the BFS queue");
+    q->capacity = capacity;
     q->front = -1;
     q->rear = -1;
 }
@@ -27,7 +38,7 @@ int isEmpty(Queue* q) {
 }
 
 void enqueue(Queue* q, int value) {
-    if (q->rear == MAX_QUEUE - 1) return;
+    if (q->rear == q->capacity - 1) return;
     if (q->front == -1) q->front = 0;
     q->items[++q->rear] = value;
 }
@@ -44,123 +55,470 @@ int dequeue(Queue* q) {
     return item;
 }
 
-// Convert index to Char name (0 -> 'A')
-char getName(int i) {
-    return 'A' + i;
-}
-
-// Convert Char name to index ('A' -> 0)
-int getIndex(char c) {
-    if (c >= 'a' && c <= 'z') c -= 32; // Handle lowercase
-    return c - 'A';
-}
-
-void bfsAndAnalyze(int startNode) {
+// All scratch arrays come from `scratch`; the caller resets it between queries
+void bfsAndAnalyze(const CsrGraph* graph, int startNode, Arena* scratch) {
     Queue q;
-    initQueue(&q);
+    initQueue(&q, graph->numNodes, scratch);
 
-    bool visited[V] = {false};
+    bool* visited = (bool*)arenaCalloc(scratch, graph->numNodes, sizeof(bool));
+    if (!visited) scratchOutOfMemory("BFS visited flags");
+    char name[16];
     
     // Variables for Risk Analysis
     int maxWeight = -1;
     int riskiestNeighbor = -1;
+    int reached = 0;
 
     // 1. Start BFS
-    printf("\n--- Analyzing Network Traffic starting from Workstation %c ---\n", getName(startNode));
+    if (!batch) {
+        graphNodeName(graph, startNode, name, sizeof(name));
+        printf("\n--- Analyzing Network Traffic starting from Workstation %s ---\n", name);
+    }
     
     visited[startNode] = true;
     enqueue(&q, startNode);
 
-    printf("BFS Traversal Order: ");
+    if (!batch) printf("BFS Traversal Order: ");
+    INSTR_TIMER_BEGIN(bfs);
+
+#ifdef DSA_INSTRUMENT
+    // Level boundaries: nodes left in the current level, nodes queued for the next
+    int levelRemaining = 1, nextLevel = 0, levels = 1;
+    INSTR_SERIES(bfs_frontier_per_level, 1);
+#endif
 
     while (!isEmpty(&q)) {
         int current = dequeue(&q);
-        printf("%c ", getName(current));
+        reached++;
+        if (!batch) {
+            graphNodeName(graph, current, name, sizeof(name));
+            printf("%s ", name);
+        }
 
         // 2. If we are currently at the suspected node, analyze its immediate connections
         if (current == startNode) {
             // We look ahead at neighbors without dequeuing them yet
-            for (int i = 0; i < V; i++) {
-                if (adj[current][i] > 0) { // If there is a connection
-                    int weight = adj[current][i];
-                    printf("\n   > Direct Contact discovered: %c (Transfer Time: %d mins)", 
-                           getName(i), weight);
-                    
-                    // Check for highest risk
-                    if (weight > maxWeight) {
-                        maxWeight = weight;
-                        riskiestNeighbor = i;
-                    }
+            for (int64_t k = graph->offsets[current]; k < graph->offsets[current + 1]; k++) {
+                int i = graph->targets[k];
+                int weight = graph->weights ? graph->weights[k] : 1;
+                if (batch) {
+                    reportBegin(batch, "contact");
+                    reportInt(batch, "node", i);
+                    reportInt(batch, "weight", weight);
+                    reportEnd(batch);
+                } else {
+                    graphNodeName(graph, i, name, sizeof(name));
+                    printf("\n   > Direct Contact discovered: %s (Transfer Time: %d mins)", 
+                           name, weight);
+                }
+                
+                // Check for highest risk
+                if (weight > maxWeight) {
+                    maxWeight = weight;
+                    riskiestNeighbor = i;
                 }
             }
         }
 
         // 3. Continue BFS: Enqueue unvisited neighbors
-        for (int i = 0; i < V; i++) {
-            if (adj[current][i] > 0 && !visited[i]) {
+        for (int64_t k = graph->offsets[current]; k < graph->offsets[current + 1]; k++) {
+            int i = graph->targets[k];
+            if (!visited[i]) {
                 visited[i] = true;
                 enqueue(&q, i);
+#ifdef DSA_INSTRUMENT
+                nextLevel++;
+#endif
             }
         }
+        INSTR_COUNT(bfs_arcs_scanned, graph->offsets[current + 1] - graph->offsets[current]);
+
+#ifdef DSA_INSTRUMENT
+        if (--levelRemaining == 0 && nextLevel > 0) {
+            INSTR_SERIES(bfs_frontier_per_level, nextLevel);
+            levelRemaining = nextLevel;
+            nextLevel = 0;
+            levels++;
+        }
+#endif
     }
-    printf("\n");
+    INSTR_TIMER_END(bfs);
+#ifdef DSA_INSTRUMENT
+    // Levels in this query: splits bfs_frontier_per_level when queries repeat
+    INSTR_SERIES(bfs_levels_per_query, levels);
+#endif
 
     // 4. Report Findings
-    printf("\n-------------------------------------------------\n");
-    printf("RISK ASSESSMENT REPORT FOR WORKSTATION %c\n", getName(startNode));
-    printf("-------------------------------------------------\n");
-    if (riskiestNeighbor != -1) {
-        printf("Highest Risk Exposure: Workstation %c\n", getName(riskiestNeighbor));
-        printf("Reason: Highest data transfer volume (%d mins).\n", maxWeight);
+    if (batch) {
+        reportBegin(batch, "risk");
+        reportInt(batch, "start", startNode);
+        if (riskiestNeighbor != -1) {
+            reportInt(batch, "riskiest", riskiestNeighbor);
+            reportInt(batch, "weight", maxWeight);
+        } else {
+            reportNull(batch, "riskiest");
+            reportNull(batch, "weight");
+        }
+        reportInt(batch, "reachable", reached);
+        reportEnd(batch);
     } else {
-        printf("No outgoing connections found from this workstation.\n");
+        printf("\n");
+        printf("\n-------------------------------------------------\n");
+        graphNodeName(graph, startNode, name, sizeof(name));
+        printf("RISK ASSESSMENT REPORT FOR WORKSTATION %s\n", name);
+        printf("-------------------------------------------------\n");
+        if (riskiestNeighbor != -1) {
+            graphNodeName(graph, riskiestNeighbor, name, sizeof(name));
+            printf("Highest Risk Exposure: Workstation %s\n", name);
+            printf("Reason: Highest data transfer volume (%d mins).\n", maxWeight);
+        } else {
+            printf("No outgoing connections found from this workstation.\n");
+        }
+        printf("-------------------------------------------------\n");
     }
-    printf("-------------------------------------------------\n");
 }
 
-int main() {
-    // Initialize Matrix with 0
-    for(int i=0; i<V; i++) 
-        for(int j=0; j<V; j++) 
-            adj[i][j] = 0;
+// ---------------------------------------------------------------------------
+// Time-Bounded Exposure (bounded Dijkstra)
+//
+// "Which workstations can the attacker reach within T minutes?"
+// Dijkstra from the suspect, stopped at the horizon: nodes are settled in
+// order of arrival time, so the output is already sorted and answers every
+// horizon <= T by a binary search. Only nodes reached before the horizon are
+// ever touched; distances are tagged with a query epoch instead of being
+// reset, so the work is proportional to the affected region.
+// ---------------------------------------------------------------------------
 
-    // Load Graph Data from Image (Screenshot 2026-02-10 13-51-13)
-    // Undirected graph: adj[u][v] = w AND adj[v][u] = w
-    
-    // A(0) connections
-    adj[0][1] = adj[1][0] = 6;  // A-B
-    // A-D line exists but has no number. Treated as 0.
+// Arrival of the attacker at a workstation
+typedef struct {
+    int node;
+    int time;
+} Arrival;
+
+// Min-Heap entry (keyed on arrival time)
+typedef struct {
+    int time;
+    int node;
+} HeapEntry;
+
+// Scratch state for exposure queries, reused across queries on one graph.
+// The heap and arrival buffers keep their capacity, so repeated queries stop
+// allocating once they have grown to the largest region seen.
+typedef struct {
+    int numNodes;
+    int* dist;           // Valid only where stamp[v] == epoch
+    unsigned* stamp;
+    unsigned epoch;
+    HeapEntry* heap;     // Min-Heap of tentative arrivals (lazy deletion)
+    int heapSize;
+    int heapCapacity;
+    Arrival* arrivals;   // Settled nodes in arrival order
+    int arrivalCount;
+    int arrivalCapacity;
+} ExposureWorkspace;
+
+// Returns 0 on success, -1 if out of memory
+int initExposure(ExposureWorkspace* ws, int numNodes) {
+    memset(ws, 0, sizeof(*ws));
+    ws->numNodes = numNodes;
+    // calloc: the OS hands out zero pages lazily, so untouched parts cost nothing
+    ws->dist = (int*)calloc(numNodes, sizeof(int));
+    ws->stamp = (unsigned*)calloc(numNodes, sizeof(unsigned));
+    return ws->dist && ws->stamp ? 0 : -1;
+}
+
+void freeExposure(ExposureWorkspace* ws) {
+    free(ws->dist);
+    free(ws->stamp);
+    free(ws->heap);
+    free(ws->arrivals);
+    memset(ws, 0, sizeof(*ws));
+}
+
+// Insert into the Min-Heap (Bubble Up). Returns -1 if the heap cannot grow.
+int heapPush(ExposureWorkspace* ws, int time, int node) {
+    if (ws->heapSize == ws->heapCapacity) {
+        int capacity = ws->heapCapacity ? ws->heapCapacity * 2 : 64;
+        HeapEntry* grown = (HeapEntry*)scratchRealloc(ws->heap, capacity * sizeof(HeapEntry));
+        if (!grown) return -1;
+        ws->heap = grown;
+        ws->heapCapacity = capacity;
+    }
+
+    int i = ws->heapSize++;
+    while (i != 0 && ws->heap[(i - 1) / 2].time > time) {
+        ws->heap[i] = ws->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    ws->heap[i].time = time;
+    ws->heap[i].node = node;
+    return 0;
+}
+
+// Remove the earliest arrival (Sift Down)
+HeapEntry heapPop(ExposureWorkspace* ws) {
+    HeapEntry top = ws->heap[0];
+    HeapEntry last = ws->heap[--ws->heapSize];
+    int i = 0;
+    while (1) {
+        int smallest = 2 * i + 1;
+        if (smallest >= ws->heapSize) break;
+        if (smallest + 1 < ws->heapSize && ws->heap[smallest + 1].time < ws->heap[smallest].time)
+            smallest++;
+        if (ws->heap[smallest].time >= last.time) break;
+        ws->heap[i] = ws->heap[smallest];
+        i = smallest;
+    }
+    if (ws->heapSize > 0) ws->heap[i] = last;
+    return top;
+}
+
+// Returns -1 if the arrival list cannot grow
+int recordArrival(ExposureWorkspace* ws, int node, int time) {
+    if (ws->arrivalCount == ws->arrivalCapacity) {
+        int capacity = ws->arrivalCapacity ? ws->arrivalCapacity * 2 : 64;
+        Arrival* grown = (Arrival*)scratchRealloc(ws->arrivals, capacity * sizeof(Arrival));
+        if (!grown) return -1;
+        ws->arrivals = grown;
+        ws->arrivalCapacity = capacity;
+    }
+    ws->arrivals[ws->arrivalCount].node = node;
+    ws->arrivals[ws->arrivalCount].time = time;
+    ws->arrivalCount++;
+    return 0;
+}
+
+// Fill ws->arrivals with every workstation reachable from startNode within
+// `horizon` minutes, sorted by arrival time (startNode itself first, at 0).
+// Negative transfer times are not meaningful here and are ignored.
+// Returns 0 on success, -1 if a scratch buffer could not grow (the arrival
+// list is then incomplete and must not be reported).
+int exposureWithin(const CsrGraph* graph, ExposureWorkspace* ws, int startNode, int horizon) {
+    ws->heapSize = 0;
+    ws->arrivalCount = 0;
+    if (++ws->epoch == 0) {
+        // Epoch wrapped around: clear the stamps once
+        memset(ws->stamp, 0, ws->numNodes * sizeof(unsigned));
+        ws->epoch = 1;
+    }
+
+    ws->stamp[startNode] = ws->epoch;
+    ws->dist[startNode] = 0;
+    if (heapPush(ws, 0, startNode) != 0) return -1;
 
-    // B(1) connections
-    adj[1][2] = adj[2][1] = 11; // B-C
-    adj[1][3] = adj[3][1] = 5;  // B-D
+    while (ws->heapSize > 0) {
+        HeapEntry e = heapPop(ws);
+        if (e.time > ws->dist[e.node]) continue; // Stale entry
+        if (recordArrival(ws, e.node, e.time) != 0) return -1;
+        INSTR_COUNT(exposure_settled, 1);
 
-    // C(2) connections
-    adj[2][3] = adj[3][2] = 17; // C-D
-    adj[2][6] = adj[6][2] = 25; // C-G
+        for (int64_t k = graph->offsets[e.node]; k < graph->offsets[e.node + 1]; k++) {
+            int v = graph->targets[k];
+            int weight = graph->weights ? graph->weights[k] : 1;
+            if (weight < 0) continue;
 
-    // D(3) connections
-    adj[3][4] = adj[4][3] = 22; // D-E
-    // D-F line exists but has no number. Treated as 0.
+            // Stop at the time horizon: nothing beyond it is ever queued
+            long long t = (long long)e.time + weight;
+            if (t > horizon) continue;
 
-    // E(4) connections
-    adj[4][5] = adj[5][4] = 10; // E-F
+            if (ws->stamp[v] != ws->epoch || t < ws->dist[v]) {
+                ws->stamp[v] = ws->epoch;
+                ws->dist[v] = (int)t;
+                if (heapPush(ws, (int)t, v) != 0) return -1;
+                INSTR_COUNT(exposure_pushes, 1);
+            }
+        }
+    }
+    return 0;
+}
+
+// Number of arrivals (excluding the suspect) within `horizon` minutes.
+// Works for any horizon up to the one the traversal was run with.
+int countWithin(const ExposureWorkspace* ws, int horizon) {
+    int lo = 0, hi = ws->arrivalCount;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (ws->arrivals[mid].time <= horizon)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo > 0 ? lo - 1 : 0;
+}
+
+// Run one traversal to the largest horizon and report every horizon from it.
+// Returns -1 (and reports nothing) if the traversal ran out of memory.
+int reportExposure(const CsrGraph* graph, ExposureWorkspace* ws, int startNode,
+                    const int* horizons, int numHorizons) {
+    int maxHorizon = 0;
+    for (int h = 0; h < numHorizons; h++)
+        if (horizons[h] > maxHorizon) maxHorizon = horizons[h];
+
+    INSTR_TIMER_BEGIN(exposure);
+    int failed = exposureWithin(graph, ws, startNode, maxHorizon) != 0;
+    INSTR_TIMER_END(exposure);
+    if (failed) {
+        reportMessage(batch, "Out of memory during exposure analysis; report aborted.\n");
+        return -1;
+    }
 
-    // F(5) connections
-    adj[5][6] = adj[6][5] = 22; // F-G
+    char name[16];
+    if (batch) {
+        // Arrival list (sorted by time), then one summary per horizon
+        for (int i = 1; i < ws->arrivalCount; i++) {
+            reportBegin(batch, "arrival");
+            reportInt(batch, "node", ws->arrivals[i].node);
+            reportInt(batch, "time", ws->arrivals[i].time);
+            reportEnd(batch);
+        }
+        for (int h = 0; h < numHorizons; h++) {
+            reportBegin(batch, "exposure");
+            reportInt(batch, "start", startNode);
+            reportInt(batch, "horizon", horizons[h]);
+            // "exposed" leaves the suspect out; risk.reachable counts it
+            reportInt(batch, "exposed", countWithin(ws, horizons[h]));
+            reportEnd(batch);
+        }
+    } else {
+        graphNodeName(graph, startNode, name, sizeof(name));
+        printf("\n-------------------------------------------------\n");
+        printf("TIME-BOUNDED EXPOSURE FROM WORKSTATION %s\n", name);
+        printf("-------------------------------------------------\n");
+        for (int i = 1; i < ws->arrivalCount; i++) {
+            graphNodeName(graph, ws->arrivals[i].node, name, sizeof(name));
+            printf("Workstation %s reachable after %d mins\n", name, ws->arrivals[i].time);
+        }
+        printf("-------------------------------------------------\n");
+        for (int h = 0; h < numHorizons; h++)
+            printf("Within %d mins: %d workstation(s) exposed\n", horizons[h], countWithin(ws, horizons[h]));
+        printf("-------------------------------------------------\n");
+    }
+    return 0;
+}
+
+// Parse a comma separated list of horizons ("10,30,60"). Returns the count, -1 if invalid.
+int parseHorizons(const char* text, int* horizons) {
+    int count = 0;
+    while (*text) {
+        char* end;
+        long value = strtol(text, &end, 10);
+        if (end == text || value < 0 || value > 1000000000 || count == MAX_HORIZONS) return -1;
+        horizons[count++] = (int)value;
+        if (*end == ',') end++;
+        else if (*end != '\0') return -1;
+        text = end;
+    }
+    return count;
+}
+
+// Usage: question4 [-q] [--within T[,T...]] [--repeat N] [graph.bin | edges.txt]
+// Without a file the built-in workstation network is used.
+// -q: no prompt or traversal output; contacts and the risk report are JSON lines.
+// --within: instead of the full BFS risk report, list the workstations reachable
+//           within T minutes of the suspect (one traversal answers every listed
+//           horizon, and it only touches the exposed region).
+// --repeat: run the analysis N times on the same scratch memory (steady-state check).
+int main(int argc, char *argv[]) {
+    CsrGraph graph;
+    ReportWriter writer;
+    INSTR_INIT("question4");
+
+    if (reportTakeQuietFlag(&argc, argv)) {
+        reportOpen(&writer, 1);
+        batch = &writer;
+    }
+
+    const char* graphPath = NULL;
+    int horizons[MAX_HORIZONS];
+    int numHorizons = 0;
+    int repeat = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+            continue;
+        }
+        if (strcmp(argv[i], "--within") == 0) {
+            numHorizons = i + 1 < argc ? parseHorizons(argv[++i], horizons) : -1;
+            if (numHorizons <= 0) {
+                reportMessage(batch, "Invalid time horizon list (expected e.g. --within 10,30,60).\n");
+                return 1;
+            }
+        } else {
+            graphPath = argv[i];
+        }
+    }
+
+    if (repeat < 1) repeat = 1;
+
+    if (graphPath) {
+        INSTR_TIMER_BEGIN(load);
+        if (graphLoad(&graph, graphPath, GRAPH_WEIGHTED | GRAPH_UNDIRECTED) != 0) return 1;
+        INSTR_TIMER_END(load);
+    } else {
+        // Load Graph Data from Image (Screenshot 2026-02-10 13-51-13)
+        // 0 = A, 1 = B, 2 = C, 3 = D, 4 = E, 5 = F, 6 = G
+        // Undirected graph: each edge is stored in both directions
+        Edge edges[] = {
+            {0, 1, 6},  // A-B
+            // A-D line exists but has no number. Treated as no connection.
+            {1, 2, 11}, // B-C
+            {1, 3, 5},  // B-D
+            {2, 3, 17}, // C-D
+            {2, 6, 25}, // C-G
+            {3, 4, 22}, // D-E
+            // D-F line exists but has no number. Treated as no connection.
+            {4, 5, 10}, // E-F
+            {5, 6, 22}  // F-G
+        };
+        int numEdges = sizeof(edges) / sizeof(edges[0]);
+        if (graphBuild(&graph, V, edges, numEdges, GRAPH_WEIGHTED | GRAPH_UNDIRECTED) != 0) return 1;
+    }
 
     // User Input
-    char input;
-    printf("Enter the suspected compromised workstation (A-G): ");
-    scanf(" %c", &input);
+    char input[32];
+    char lastName[16];
+    graphNodeName(&graph, graph.numNodes - 1, lastName, sizeof(lastName));
+    if (!batch)
+        printf("Enter the suspected compromised workstation (%s-%s): ", graph.numNodes <= 26 ? "A" : "0", lastName);
+    int startIdx = -1, rc = 0;
+    if (scanf(" %31s", input) == 1)
+        startIdx = graphParseNode(&graph, input);
 
-    int startIdx = getIndex(input);
+    if (startIdx >= 0) {
+        Arena scratch;
+        ExposureWorkspace ws;
+        arenaInit(&scratch, 0);
+        int ready = numHorizons == 0 || initExposure(&ws, graph.numNodes) == 0;
+        if (!ready) {
+            reportMessage(batch, "Out of memory for %d workstations.\n", graph.numNodes);
+            rc = 1;
+        }
 
-    if (startIdx >= 0 && startIdx < V) {
-        bfsAndAnalyze(startIdx);
+        for (int run = 0; ready && run < repeat; run++) {
+            long long allocsBefore = scratchSystemAllocs;
+            // The full BFS walks the whole component; an exposure query skips it
+            // so its cost stays proportional to the region inside the horizon
+            if (numHorizons > 0) {
+                if (reportExposure(&graph, &ws, startIdx, horizons, numHorizons) != 0) {
+                    rc = 1;
+                    break;
+                }
+            } else {
+                bfsAndAnalyze(&graph, startIdx, &scratch);
+            }
+            arenaReset(&scratch);
+            INSTR_SERIES(scratch_allocs_per_query, scratchSystemAllocs - allocsBefore);
+        }
+
+        if (numHorizons > 0) freeExposure(&ws);
+        arenaFree(&scratch);
     } else {
-        printf("Invalid Workstation ID.\n");
+        reportMessage(batch, "Invalid Workstation ID.\n");
+        // Batch callers only see the exit status; the interactive prompt keeps exiting 0
+        if (batch) rc = 1;
     }
 
-    return 0;
+    graphFree(&graph);
+    if (batch && reportClose(batch) != 0) rc = 1;
+    return rc;
 }
@@ -3,155 +3,231 @@
 #include <string.h>
 #include <limits.h>
 
-// Total Nodes: A, B, C, D, E, F, G, H, I, J
+#include "../common/graph.h"
+#include "../common/instrument.h"
+#include "../common/report.h"
+#include "../common/arena.h"
+
+// Total Nodes in the built-in dataset: A, B, C, D, E, F, G, H, I, J
 #define V 10 
-#define MAX_EDGES 40 // Sufficient for bidirectional graph
-
-// Edge Structure
-typedef struct {
-    int src, dest, weight;
-} Edge;
-
-// Graph Structure
-typedef struct {
-    Edge edges[MAX_EDGES];
-    int numEdges;
-} Graph;
-
-// Helper to get Branch Name by Index
-void getBranchName(int index, char *buffer) {
-    // Mapping: 0=A, 1=B, 2=C, 3=D, 4=E, 5=F, 6=G, 7=H, 8=I, 9=J
-    const char *names[] = {"A", "B", "C", "D", "E", "F", "G", "H", "I", "J"};
-    
-    if (index >= 0 && index < V) {
-        strcpy(buffer, names[index]);
-    } else {
-        strcpy(buffer, "?");
-    }
-}
 
-// Helper to add a bidirectional edge
-void addEdge(Graph *g, int u, int v, int w) {
-    // Add direction u -> v
-    g->edges[g->numEdges].src = u;
-    g->edges[g->numEdges].dest = v;
-    g->edges[g->numEdges].weight = w;
-    g->numEdges++;
-
-    // Add direction v -> u (Undirected Graph)
-    g->edges[g->numEdges].src = v;
-    g->edges[g->numEdges].dest = u;
-    g->edges[g->numEdges].weight = w;
-    g->numEdges++;
-}
+// Quiet/batch mode writer (-q). NULL means narrative output.
+ReportWriter *batch = NULL;
+
+// Distances are long long: a path of int weights overflows an int long before
+// it overflows this. Only a negative cycle can drive a distance further down
+// than DIST_FLOOR, so relaxation stops there instead of wrapping around.
+#define DIST_INFINITY LLONG_MAX
+#define DIST_FLOOR (LLONG_MIN / 2)
 
 // The Bellman-Ford Algorithm
-void BellmanFord(Graph* graph, int src) {
-    int dist[V];
-    char nameBuffer[10];
-    char uName[10], vName[10];
+// Scratch (the distance table) comes from `scratch`; the caller resets it between queries
+void BellmanFord(const CsrGraph* graph, int src, Arena* scratch) {
+    int n = graph->numNodes;
+    long long* dist = (long long*)arenaAlloc(scratch, n * sizeof(long long));
+    if (!dist) scratchOutOfMemory("the distance table");
+    char nameBuffer[16];
+    char uName[16], vName[16];
 
     // 1. Initialize distances
-    // Set all to "Infinity" (INT_MAX), except source
-    for (int i = 0; i < V; i++) dist[i] = INT_MAX;
+    // Set all to "Infinity" (DIST_INFINITY), except source
+    for (int i = 0; i < n; i++) dist[i] = DIST_INFINITY;
     dist[src] = 0;
 
     // 2. Relax edges |V| - 1 times
-    // This finds the shortest path for all nodes
-    for (int i = 1; i <= V - 1; i++) {
-        for (int j = 0; j < graph->numEdges; j++) {
-            int u = graph->edges[j].src;
-            int v = graph->edges[j].dest;
-            int weight = graph->edges[j].weight;
-
-            if (dist[u] != INT_MAX && dist[u] + weight < dist[v]) {
-                dist[v] = dist[u] + weight;
+    // This finds the shortest path for all nodes.
+    // Stop early once a full pass changes nothing: later passes cannot either.
+    INSTR_TIMER_BEGIN(relax);
+    int passes = 0;
+    for (int i = 1; i <= n - 1; i++) {
+        long long changed = 0; // Relaxations in this pass
+        passes++;
+        for (int u = 0; u < n; u++) {
+            if (dist[u] == DIST_INFINITY) continue;
+            for (int64_t k = graph->offsets[u]; k < graph->offsets[u + 1]; k++) {
+                int v = graph->targets[k];
+                int weight = graph->weights ? graph->weights[k] : 1;
+
+                long long candidate = dist[u] + weight;
+                if (candidate < DIST_FLOOR) candidate = DIST_FLOOR;
+                if (candidate < dist[v]) {
+                    dist[v] = candidate;
+                    changed++;
+                }
             }
         }
+        INSTR_SERIES(bf_relaxations_per_pass, changed);
+        if (!changed) break;
     }
+    INSTR_TIMER_END(relax);
+    // Passes in this query: splits bf_relaxations_per_pass when queries repeat
+    INSTR_SERIES(bf_passes_per_query, passes);
 
     // 3. Detect Negative-Weight Cycles
+    INSTR_TIMER_BEGIN(cycle_check);
     int cycleDetected = 0;
-    for (int j = 0; j < graph->numEdges; j++) {
-        int u = graph->edges[j].src;
-        int v = graph->edges[j].dest;
-        int weight = graph->edges[j].weight;
-
-        // If we can still reduce the cost, a negative cycle exists
-        if (dist[u] != INT_MAX && dist[u] + weight < dist[v]) {
-            cycleDetected = 1;
-            getBranchName(u, uName);
-            getBranchName(v, vName);
-            printf("\n[ALERT] Negative Weight Cycle Detected involving %s -> %s!\n", 
-                   uName, vName);
+    for (int u = 0; u < n; u++) {
+        if (dist[u] == DIST_INFINITY) continue;
+        for (int64_t k = graph->offsets[u]; k < graph->offsets[u + 1]; k++) {
+            int v = graph->targets[k];
+            int weight = graph->weights ? graph->weights[k] : 1;
+
+            // If we can still reduce the cost, a negative cycle exists
+            if (dist[u] + weight < dist[v]) {
+                cycleDetected = 1;
+                if (batch) {
+                    reportBegin(batch, "negative_cycle");
+                    reportInt(batch, "src", u);
+                    reportInt(batch, "dest", v);
+                    reportEnd(batch);
+                } else {
+                    graphNodeName(graph, u, uName, sizeof(uName));
+                    graphNodeName(graph, v, vName, sizeof(vName));
+                    printf("\n[ALERT] Negative Weight Cycle Detected involving %s -> %s!\n", 
+                           uName, vName);
+                }
+            }
         }
     }
 
-    if (!cycleDetected) {
-        printf("\n[Status] No negative-weight cycles detected.\n");
-    }
+    INSTR_TIMER_END(cycle_check);
+
+    // Quiet mode: one record per node, then the cycle status
+    if (batch) {
+        for (int i = 0; i < n; i++) {
+            reportBegin(batch, "dist");
+            reportInt(batch, "node", i);
+            if (dist[i] == DIST_INFINITY)
+                reportNull(batch, "dist");
+            else
+                reportInt(batch, "dist", dist[i]);
+            reportEnd(batch);
+        }
+        reportBegin(batch, "status");
+        reportInt(batch, "source", src);
+        reportBool(batch, "negative_cycle", cycleDetected);
+        reportEnd(batch);
+    } else {
+        if (!cycleDetected) {
+            printf("\n[Status] No negative-weight cycles detected.\n");
+        }
 
-    // 4. Display Final Results
-    printf("\n--- Shortest Transaction Paths from Branch A ---\n");
-    printf("%-10s | %-15s\n", "Branch", "Min Risk (Cost)");
-    printf("------------------------------\n");
+        // 4. Display Final Results
+        graphNodeName(graph, src, nameBuffer, sizeof(nameBuffer));
+        printf("\n--- Shortest Transaction Paths from Branch %s ---\n", nameBuffer);
+        printf("%-10s | %-15s\n", "Branch", "Min Risk (Cost)");
+        printf("------------------------------\n");
     
-    // Print alphabetically or by Index? Let's verify mapping:
-    // A=0, B=1, C=2, D=3, E=4, F=5, G=6, H=7, I=8, J=9
-    for (int i = 0; i < V; i++) {
-        getBranchName(i, nameBuffer);
-        if (dist[i] == INT_MAX)
-            printf("%-10s | Unreachable\n", nameBuffer);
-        else
-            printf("%-10s | %d\n", nameBuffer, dist[i]);
+        // Print alphabetically or by Index? Let's verify mapping:
+        // A=0, B=1, C=2, D=3, E=4, F=5, G=6, H=7, I=8, J=9
+        for (int i = 0; i < n; i++) {
+            graphNodeName(graph, i, nameBuffer, sizeof(nameBuffer));
+            if (dist[i] == DIST_INFINITY)
+                printf("%-10s | Unreachable\n", nameBuffer);
+            else
+                printf("%-10s | %lld\n", nameBuffer, dist[i]);
+        }
+        printf("------------------------------\n");
     }
-    printf("------------------------------\n");
 }
 
-int main() {
-    Graph graph;
-    graph.numEdges = 0;
-
-    // NODE MAPPING INDEX:
-    // A=0, B=1, C=2, D=3, E=4, F=5, G=6, H=7, I=8, J=9
-    
-    // Edges connected to A
-    addEdge(&graph, 0, 1, 4);   // A-B
-    addEdge(&graph, 0, 3, 16);  // A-D
-
-    // Edges connected to B (excluding A)
-    addEdge(&graph, 1, 2, 6);   // B-C
-    addEdge(&graph, 1, 3, 6);   // B-D
-    addEdge(&graph, 1, 9, 7);   // B-J
-
-    // Edges connected to C (excluding B)
-    addEdge(&graph, 2, 6, 9);   // C-G
-
-    // Edges connected to D (excluding A, B)
-    addEdge(&graph, 3, 9, 0);   // D-J (Line present, no number. Assuming 0)
-    addEdge(&graph, 3, 4, 7);   // D-E
-
-    // Edges connected to J (excluding B, D)
-    addEdge(&graph, 9, 5, 3);   // J-F
-
-    // Edges connected to E (excluding D)
-    addEdge(&graph, 4, 5, 10);  // E-F
-    addEdge(&graph, 4, 8, 2);   // E-I
+// Usage: question5 [-q] [--repeat N] [graph.bin | edges.txt] [source]
+// Without a file the built-in branch network is used (source = A).
+// -q: distances and cycle status are written as JSON lines instead of a table.
+// --repeat: run the query N times on one scratch arena (steady-state check).
+int main(int argc, char *argv[]) {
+    CsrGraph graph;
+    ReportWriter writer;
+    INSTR_INIT("question5");
+
+    if (reportTakeQuietFlag(&argc, argv)) {
+        reportOpen(&writer, 1);
+        batch = &writer;
+    }
 
-    // Edges connected to F (excluding J, E)
-    addEdge(&graph, 5, 8, 10);  // F-I
-    addEdge(&graph, 5, 6, 0);   // F-G (Line present, no number. Assuming 0)
+    // Positional arguments: graph file, source node
+    const char *positional[2] = {NULL, NULL};
+    int numPositional = 0;
+    int repeat = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = atoi(argv[++i]);
+        else if (numPositional < 2)
+            positional[numPositional++] = argv[i];
+    }
+    if (repeat < 1) repeat = 1;
 
-    // Edges connected to G (excluding C, F)
-    addEdge(&graph, 6, 7, 13);  // G-H
+    if (positional[0]) {
+        INSTR_TIMER_BEGIN(load);
+        if (graphLoad(&graph, positional[0], GRAPH_WEIGHTED | GRAPH_UNDIRECTED) != 0) return 1;
+        graphAdviseSequential(&graph); // Every pass sweeps all rows in order
+        INSTR_TIMER_END(load);
+    } else {
+        // NODE MAPPING INDEX:
+        // A=0, B=1, C=2, D=3, E=4, F=5, G=6, H=7, I=8, J=9
+        // Undirected graph: each edge is stored in both directions
+        Edge edges[] = {
+            // Edges connected to A
+            {0, 1, 4},   // A-B
+            {0, 3, 16},  // A-D
+
+            // Edges connected to B (excluding A)
+            {1, 2, 6},   // B-C
+            {1, 3, 6},   // B-D
+            {1, 9, 7},   // B-J
+
+            // Edges connected to C (excluding B)
+            {2, 6, 9},   // C-G
+
+            // Edges connected to D (excluding A, B)
+            {3, 9, 0},   // D-J (Line present, no number. Assuming 0)
+            {3, 4, 7},   // D-E
+
+            // Edges connected to J (excluding B, D)
+            {9, 5, 3},   // J-F
+
+            // Edges connected to E (excluding D)
+            {4, 5, 10},  // E-F
+            {4, 8, 2},   // E-I
+
+            // Edges connected to F (excluding J, E)
+            {5, 8, 10},  // F-I
+            {5, 6, 0},   // F-G (Line present, no number. Assuming 0)
+
+            // Edges connected to G (excluding C, F)
+            {6, 7, 13},  // G-H
+
+            // (H and I are fully connected above)
+
+            /* UNCOMMENT LINE BELOW TO TEST NEGATIVE CYCLE DETECTION */
+            // {9, 1, -20}, // Creates cycle B-J-B with negative sum
+        };
+        int numEdges = sizeof(edges) / sizeof(edges[0]);
+        if (graphBuild(&graph, V, edges, numEdges, GRAPH_WEIGHTED | GRAPH_UNDIRECTED) != 0) return 1;
+    }
 
-    // (H and I are fully connected above)
+    int source = 0; // Start from Node 0 (Branch A)
+    if (positional[1]) {
+        source = graphParseNode(&graph, positional[1]);
+        if (source < 0) {
+            reportMessage(batch, "Invalid Branch ID.\n");
+            graphFree(&graph);
+            return 1;
+        }
+    }
 
-    /* UNCOMMENT LINE BELOW TO TEST NEGATIVE CYCLE DETECTION */
-    // addEdge(&graph, 9, 1, -20); // Creates cycle B-J-B with negative sum
+    Arena scratch;
+    arenaInit(&scratch, 0);
 
-    printf("Calculating Minimum Risk Paths (Bellman-Ford)...\n");
-    BellmanFord(&graph, 0); // Start from Node 0 (Branch A)
+    for (int run = 0; run < repeat; run++) {
+        long long allocsBefore = scratchSystemAllocs;
+        if (!batch) printf("Calculating Minimum Risk Paths (Bellman-Ford)...\n");
+        BellmanFord(&graph, source, &scratch);
+        arenaReset(&scratch);
+        INSTR_SERIES(scratch_allocs_per_query, scratchSystemAllocs - allocsBefore);
+    }
 
-    return 0;
+    arenaFree(&scratch);
+    graphFree(&graph);
+    return batch && reportClose(batch) != 0 ? 1 : 0;
 }
@@ -0,0 +1,327 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include "generators.h"
+
+// Benchmark suite: generates seeded workloads, runs the compiled Q1-Q5
+// programs over a size sweep and reports wall time, throughput and peak RSS.
+//
+// Usage (from the repository root):
+//   bench/bench [--format csv|json] [--seed N] [--reps N] [--max-nodes N]
+//               [--only q1|q2|q3|q4|q5] [--root DIR] [--work DIR] [--narrative]
+//   bench/bench gen prio|er|rmat|grid <nodes> <out> [seed]
+// Programs run in quiet mode (-q) unless --narrative is given.
+// Exits 1 if any program run failed (non-zero status column) or a workload
+// could not be generated.
+
+#define MAX_REPS 32
+
+typedef struct {
+    const char *format;
+    uint64_t seed;
+    int reps;
+    int maxNodes;
+    const char *only;
+    const char *root;
+    const char *work;
+    int narrative;
+} Options;
+
+typedef struct {
+    const char *algorithm;
+    const char *program;
+    const char *generator;
+    int nodes;
+    long long items;     // Priorities for heaps, arcs for graphs
+    double wallMin;
+    double wallMedian;
+    long peakRssKb;
+    int status;
+} Result;
+
+static int resultCount = 0;
+static int failedCount = 0;  // Rows with a non-zero status, plus workloads that could not be generated
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Run one program once with stdout/stderr discarded.
+// Returns the exit status; fills wall time and the child's peak RSS.
+static int runOnce(const char *program, const char *input, const char *stdinPath,
+                   int narrative, double *wall, long *rssKb) {
+    *wall = 0;
+    *rssKb = 0;
+    double start = nowSeconds();
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        int in = open(stdinPath ? stdinPath : "/dev/null", O_RDONLY);
+        if (devnull >= 0) {
+            dup2(devnull, STDOUT_FILENO);
+            dup2(devnull, STDERR_FILENO);
+        }
+        if (in >= 0) dup2(in, STDIN_FILENO);
+        if (narrative)
+            execl(program, program, input, (char *)NULL);
+        else
+            execl(program, program, "-q", input, (char *)NULL);
+        _exit(127);
+    }
+
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        perror("wait4");
+        return -1;
+    }
+    *wall = nowSeconds() - start;
+    *rssKb = usage.ru_maxrss; // Kilobytes on Linux
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static void printHeader(const Options *opt) {
+    if (strcmp(opt->format, "json") == 0)
+        printf("[\n");
+    else
+        printf("algorithm,program,generator,nodes,items,reps,wall_ms_min,wall_ms_median,"
+               "throughput_per_s,peak_rss_kb,status\n");
+    fflush(stdout);
+}
+
+static void printFooter(const Options *opt) {
+    if (strcmp(opt->format, "json") == 0) printf("\n]\n");
+}
+
+static void printResult(const Options *opt, const Result *r) {
+    double throughput = r->wallMin > 0 ? r->items / r->wallMin : 0;
+    if (strcmp(opt->format, "json") == 0) {
+        printf("%s  {\"algorithm\": \"%s\", \"program\": \"%s\", \"generator\": \"%s\", "
+               "\"nodes\": %d, \"items\": %lld, \"reps\": %d, \"wall_ms_min\": %.3f, "
+               "\"wall_ms_median\": %.3f, \"throughput_per_s\": %.0f, \"peak_rss_kb\": %ld, "
+               "\"status\": %d}",
+               resultCount ? ",\n" : "", r->algorithm, r->program, r->generator, r->nodes,
+               r->items, opt->reps, r->wallMin * 1e3, r->wallMedian * 1e3, throughput,
+               r->peakRssKb, r->status);
+    } else {
+        printf("%s,%s,%s,%d,%lld,%d,%.3f,%.3f,%.0f,%ld,%d\n",
+               r->algorithm, r->program, r->generator, r->nodes, r->items, opt->reps,
+               r->wallMin * 1e3, r->wallMedian * 1e3, throughput, r->peakRssKb, r->status);
+    }
+    resultCount++;
+    fflush(stdout);
+}
+
+// Time `reps` runs of one program on one input and report the result row
+static void measure(const Options *opt, Result *r, const char *input, const char *stdinPath) {
+    char program[512];
+    snprintf(program, sizeof(program), "%s/%s", opt->root, r->program);
+
+    double walls[MAX_REPS];
+    r->peakRssKb = 0;
+    r->status = 0;
+    for (int i = 0; i < opt->reps; i++) {
+        long rss = 0;
+        int status = runOnce(program, input, stdinPath, opt->narrative, &walls[i], &rss);
+        if (status != 0) {
+            fprintf(stderr, "%s %s: exit status %d\n", program, input, status);
+            r->status = status;
+        }
+        if (rss > r->peakRssKb) r->peakRssKb = rss;
+    }
+
+    if (r->status != 0) failedCount++;
+    qsort(walls, opt->reps, sizeof(double), compareDoubles);
+    r->wallMin = walls[0];
+    r->wallMedian = walls[opt->reps / 2];
+    printResult(opt, r);
+}
+
+static int selected(const Options *opt, const char *name) {
+    return opt->only == NULL || strcmp(opt->only, name) == 0;
+}
+
+// Generate one graph of the requested family with about `nodes` nodes
+static int generateGraph(CsrGraph *g, const char *kind, int nodes, uint64_t seed) {
+    if (strcmp(kind, "er") == 0)
+        return genErdosRenyi(g, nodes, (int64_t)nodes * 4, 100, seed);
+    if (strcmp(kind, "rmat") == 0) {
+        int scale = 1;
+        while ((1 << (scale + 1)) <= nodes) scale++;
+        return genRmat(g, scale, 4, 100, seed);
+    }
+    if (strcmp(kind, "grid") == 0) {
+        int side = 1;
+        while ((side + 1) * (side + 1) <= nodes) side++;
+        return genGrid(g, side, side, 100, seed);
+    }
+    fprintf(stderr, "Unknown generator: %s\n", kind);
+    return -1;
+}
+
+static void runHeapSweep(const Options *opt) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/dsa_bench_prio_%d.txt", opt->work, (int)getpid());
+
+    for (int n = 1024; n <= opt->maxNodes; n *= 4) {
+        if (genPriorityStream(path, n, 1000000, opt->seed + n) != 0) {
+            failedCount++;
+            break;
+        }
+
+        Result r = {0};
+        r.generator = "uniform";
+        r.nodes = n;
+        r.items = n;
+        if (selected(opt, "q1")) {
+            r.algorithm = "heap_build";
+            r.program = "Q1/question1";
+            measure(opt, &r, path, NULL);
+        }
+        if (selected(opt, "q2")) {
+            r.algorithm = "heap_extract_all";
+            r.program = "Q2/question2";
+            measure(opt, &r, path, NULL);
+        }
+    }
+    unlink(path);
+}
+
+static void runGraphSweep(const Options *opt) {
+    static const char *kinds[] = {"er", "rmat", "grid"};
+    static const struct { const char *name, *algorithm, *program; } programs[] = {
+        {"q3", "kruskal_mst", "Q3/question3"},
+        {"q4", "bfs", "Q4/question4"},
+        {"q5", "bellman_ford", "Q5/question5"},
+    };
+
+    char graphPath[512], stdinPath[512];
+    snprintf(graphPath, sizeof(graphPath), "%s/dsa_bench_graph_%d.bin", opt->work, (int)getpid());
+    snprintf(stdinPath, sizeof(stdinPath), "%s/dsa_bench_stdin_%d.txt", opt->work, (int)getpid());
+
+    // Q4 reads the suspected workstation from stdin
+    FILE *fp = fopen(stdinPath, "w");
+    if (!fp) {
+        perror(stdinPath);
+        failedCount++;
+        return;
+    }
+    fprintf(fp, "0\n");
+    fclose(fp);
+
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        for (int n = 1024; n <= opt->maxNodes; n *= 4) {
+            CsrGraph g;
+            if (generateGraph(&g, kinds[k], n, opt->seed + n) != 0) {
+                failedCount++;
+                break;
+            }
+            int rc = graphSaveBinary(&g, graphPath);
+            Result r = {0};
+            r.generator = kinds[k];
+            r.nodes = g.numNodes;
+            r.items = g.numArcs;
+            graphFree(&g);
+            if (rc != 0) {
+                failedCount++;
+                break;
+            }
+
+            for (size_t p = 0; p < sizeof(programs) / sizeof(programs[0]); p++) {
+                if (!selected(opt, programs[p].name)) continue;
+                r.algorithm = programs[p].algorithm;
+                r.program = programs[p].program;
+                measure(opt, &r, graphPath, stdinPath);
+            }
+        }
+    }
+    unlink(graphPath);
+    unlink(stdinPath);
+}
+
+// bench gen <kind> <nodes> <out> [seed]
+static int generateCommand(int argc, char *argv[]) {
+    if (argc < 5) {
+        fprintf(stderr, "Usage: %s gen prio|er|rmat|grid <nodes> <out> [seed]\n", argv[0]);
+        return 1;
+    }
+    const char *kind = argv[2];
+    int nodes = atoi(argv[3]);
+    const char *out = argv[4];
+    uint64_t seed = argc > 5 ? strtoull(argv[5], NULL, 10) : 1;
+
+    if (strcmp(kind, "prio") == 0)
+        return genPriorityStream(out, nodes, 1000000, seed) == 0 ? 0 : 1;
+
+    CsrGraph g;
+    if (generateGraph(&g, kind, nodes, seed) != 0) return 1;
+    int rc = graphSaveBinary(&g, out);
+    if (rc == 0) printf("Wrote %s (%d nodes, %lld arcs)\n", out, g.numNodes, (long long)g.numArcs);
+    graphFree(&g);
+    return rc == 0 ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "gen") == 0) return generateCommand(argc, argv);
+
+    Options opt = {"csv", 42, 3, 65536, NULL, ".", "/tmp", 0};
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--narrative") == 0) {
+            opt.narrative = 1;
+            continue;
+        }
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            fprintf(stderr, "Missing value for %s\n", argv[i]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--format") == 0) opt.format = value;
+        else if (strcmp(argv[i], "--seed") == 0) opt.seed = strtoull(value, NULL, 10);
+        else if (strcmp(argv[i], "--reps") == 0) opt.reps = atoi(value);
+        else if (strcmp(argv[i], "--max-nodes") == 0) opt.maxNodes = atoi(value);
+        else if (strcmp(argv[i], "--only") == 0) opt.only = value;
+        else if (strcmp(argv[i], "--root") == 0) opt.root = value;
+        else if (strcmp(argv[i], "--work") == 0) opt.work = value;
+        else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+        i++;
+    }
+    if (opt.reps < 1) opt.reps = 1;
+    if (opt.reps > MAX_REPS) opt.reps = MAX_REPS;
+    if (strcmp(opt.format, "csv") != 0 && strcmp(opt.format, "json") != 0) {
+        fprintf(stderr, "Unknown format: %s (use csv or json)\n", opt.format);
+        return 1;
+    }
+
+    printHeader(&opt);
+    runHeapSweep(&opt);
+    runGraphSweep(&opt);
+    printFooter(&opt);
+
+    // A crashing or failing program must not look like a clean run to CI
+    if (failedCount > 0) {
+        fprintf(stderr, "bench: %d failed run(s) or workload(s)\n", failedCount);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "generators.h"
+
+void rngSeed(Rng *rng, uint64_t seed) {
+    rng->state = seed;
+}
+
+uint64_t rngNext(Rng *rng) {
+    uint64_t z = (rng->state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+uint64_t rngRange(Rng *rng, uint64_t bound) {
+    // Multiply-shift: unbiased enough for workload generation, no division
+    return (uint64_t)(((unsigned __int128)rngNext(rng) * bound) >> 64);
+}
+
+int genPriorityStream(const char *path, int n, int maxPriority, uint64_t seed) {
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        perror(path);
+        return -1;
+    }
+
+    Rng rng;
+    rngSeed(&rng, seed);
+    for (int i = 0; i < n; i++)
+        fprintf(fp, "%d\n", 1 + (int)rngRange(&rng, (uint64_t)maxPriority));
+
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "%s: write failed\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// Build an undirected weighted CSR graph from a generated edge list
+static int buildGenerated(CsrGraph *g, int n, Edge *edges, int64_t m) {
+    int rc = graphBuild(g, n, edges, m, GRAPH_WEIGHTED | GRAPH_UNDIRECTED);
+    free(edges);
+    return rc;
+}
+
+int genErdosRenyi(CsrGraph *g, int n, int64_t m, int maxWeight, uint64_t seed) {
+    if (n < 2) return -1;
+    Edge *edges = malloc((size_t)m * sizeof(Edge) + 1);
+    if (!edges) return -1;
+
+    Rng rng;
+    rngSeed(&rng, seed);
+    for (int64_t e = 0; e < m; e++) {
+        int u = (int)rngRange(&rng, n);
+        int v = (int)rngRange(&rng, n - 1);
+        if (v >= u) v++; // Skip self loops without rejection
+        edges[e].src = u;
+        edges[e].dest = v;
+        edges[e].weight = 1 + (int)rngRange(&rng, maxWeight);
+    }
+    return buildGenerated(g, n, edges, m);
+}
+
+int genRmat(CsrGraph *g, int scale, int edgeFactor, int maxWeight, uint64_t seed) {
+    if (scale < 1 || scale > 30) return -1;
+    int n = 1 << scale;
+    int64_t m = (int64_t)edgeFactor * n;
+    Edge *edges = malloc((size_t)m * sizeof(Edge) + 1);
+    if (!edges) return -1;
+
+    // Quadrant probabilities scaled to 2^32
+    const uint64_t a = (uint64_t)(0.57 * 4294967296.0);
+    const uint64_t ab = (uint64_t)(0.76 * 4294967296.0);
+    const uint64_t abc = (uint64_t)(0.95 * 4294967296.0);
+
+    Rng rng;
+    rngSeed(&rng, seed);
+    for (int64_t e = 0; e < m; e++) {
+        int u = 0, v = 0;
+        for (int bit = 0; bit < scale; bit++) {
+            uint64_t r = rngNext(&rng) >> 32;
+            if (r >= abc)     { u |= 1 << bit; v |= 1 << bit; }
+            else if (r >= ab) { u |= 1 << bit; }
+            else if (r >= a)  { v |= 1 << bit; }
+        }
+        edges[e].src = u;
+        edges[e].dest = v;
+        edges[e].weight = 1 + (int)rngRange(&rng, maxWeight);
+    }
+    return buildGenerated(g, n, edges, m);
+}
+
+int genGrid(CsrGraph *g, int rows, int cols, int maxWeight, uint64_t seed) {
+    if (rows < 1 || cols < 1) return -1;
+    int n = rows * cols;
+    int64_t m = (int64_t)rows * (cols - 1) + (int64_t)(rows - 1) * cols;
+    Edge *edges = malloc((size_t)m * sizeof(Edge) + 1);
+    if (!edges) return -1;
+
+    Rng rng;
+    rngSeed(&rng, seed);
+    int64_t e = 0;
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int u = r * cols + c;
+            if (c + 1 < cols) {
+                edges[e].src = u;
+                edges[e].dest = u + 1;
+                edges[e++].weight = 1 + (int)rngRange(&rng, maxWeight);
+            }
+            if (r + 1 < rows) {
+                edges[e].src = u;
+                edges[e].dest = u + cols;
+                edges[e++].weight = 1 + (int)rngRange(&rng, maxWeight);
+            }
+        }
+    }
+    return buildGenerated(g, n, edges, m);
+}
@@ -0,0 +1,34 @@
+#ifndef DSA_GENERATORS_H
+#define DSA_GENERATORS_H
+
+#include <stdint.h>
+
+#include "../common/graph.h"
+
+// Seeded workload generators for the benchmark suite.
+// The same seed always produces the same workload.
+
+// Small, fast PRNG (SplitMix64)
+typedef struct {
+    uint64_t state;
+} Rng;
+
+void rngSeed(Rng *rng, uint64_t seed);
+uint64_t rngNext(Rng *rng);
+// Uniform integer in [0, bound)
+uint64_t rngRange(Rng *rng, uint64_t bound);
+
+// Random priority stream for the heap programs (Q1, Q2), written as text.
+int genPriorityStream(const char *path, int n, int maxPriority, uint64_t seed);
+
+// Erdos-Renyi G(n, m): m edges with uniformly random endpoints (no self loops).
+int genErdosRenyi(CsrGraph *g, int n, int64_t m, int maxWeight, uint64_t seed);
+
+// R-MAT (Chakrabarti et al.) with the Graph500 parameters a=0.57, b=c=0.19.
+// 2^scale nodes, edgeFactor * 2^scale edges; skewed, power-law-like degrees.
+int genRmat(CsrGraph *g, int scale, int edgeFactor, int maxWeight, uint64_t seed);
+
+// rows x cols 4-neighbour grid (road-network-like: large diameter).
+int genGrid(CsrGraph *g, int rows, int cols, int maxWeight, uint64_t seed);
+
+#endif
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "instrument.h"
+
+#define ARENA_ALIGN 16
+
+long long scratchSystemAllocs = 0;
+
+// Block header is padded so the first allocation is aligned too
+#define HEADER_SIZE ((sizeof(ArenaBlock) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+static char *blockData(ArenaBlock *block) {
+    return (char *)block + HEADER_SIZE;
+}
+
+void arenaInit(Arena *arena, size_t minBlockSize) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->minBlockSize = minBlockSize ? minBlockSize : 64 * 1024;
+}
+
+static ArenaBlock *newBlock(size_t size) {
+    ArenaBlock *block = malloc(HEADER_SIZE + size);
+    if (!block) return NULL;
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    scratchSystemAllocs++;
+    INSTR_COUNT(arena_blocks, 1);
+    return block;
+}
+
+void *arenaAlloc(Arena *arena, size_t bytes) {
+    bytes = (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    // Walk forward through blocks kept from earlier queries
+    ArenaBlock *block = arena->current;
+    while (block && block->used + bytes > block->size) {
+        if (!block->next) break;
+        block = block->next;
+        arena->current = block;
+    }
+
+    if (!block || block->used + bytes > block->size) {
+        // Grow geometrically so a steady workload settles on a few blocks
+        size_t size = arena->minBlockSize;
+        if (block && size < block->size * 2) size = block->size * 2;
+        if (size < bytes) size = bytes;
+
+        ArenaBlock *fresh = newBlock(size);
+        if (!fresh) return NULL;
+        if (block)
+            block->next = fresh;
+        else
+            arena->first = fresh;
+        arena->current = block = fresh;
+    }
+
+    void *ptr = blockData(block) + block->used;
+    block->used += bytes;
+    return ptr;
+}
+
+void *arenaCalloc(Arena *arena, size_t count, size_t size) {
+    void *ptr = arenaAlloc(arena, count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void arenaReset(Arena *arena) {
+    for (ArenaBlock *block = arena->first; block; block = block->next)
+        block->used = 0;
+    arena->current = arena->first;
+}
+
+void arenaFree(Arena *arena) {
+    ArenaBlock *block = arena->first;
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->first = arena->current = NULL;
+}
+
+void scratchOutOfMemory(const char *what) {
+    fprintf(stderr, "Out of memory allocating %s\n", what);
+    exit(1);
+}
+
+void *scratchRealloc(void *ptr, size_t bytes) {
+    scratchSystemAllocs++;
+    return realloc(ptr, bytes);
+}
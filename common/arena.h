@@ -0,0 +1,45 @@
+#ifndef DSA_ARENA_H
+#define DSA_ARENA_H
+
+#include <stddef.h>
+
+// Per-query scratch arena.
+//
+// Scratch arrays (dist, visited, union-find subsets, edge buffers, queues) are
+// carved out of large blocks instead of being malloc'ed one by one. Between
+// queries the arena is reset, not freed: the blocks stay, so once the first
+// query has sized them, later queries allocate nothing from the system.
+
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t size;
+    size_t used;
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock *first;
+    ArenaBlock *current;
+    size_t minBlockSize;
+} Arena;
+
+// Number of system allocations made for scratch memory (arena blocks and
+// scratchRealloc growth). Steady-state queries leave it unchanged.
+extern long long scratchSystemAllocs;
+
+void arenaInit(Arena *arena, size_t minBlockSize);
+// 16-byte aligned; contents are uninitialised. Returns NULL if out of memory.
+void *arenaAlloc(Arena *arena, size_t bytes);
+// Same, zero-filled
+void *arenaCalloc(Arena *arena, size_t count, size_t size);
+// Make all memory available again (keeps the blocks)
+void arenaReset(Arena *arena);
+void arenaFree(Arena *arena);
+
+// realloc for growable scratch buffers that live across queries; counted above
+void *scratchRealloc(void *ptr, size_t bytes);
+
+// Report that scratch memory for `what` could not be allocated and exit(1).
+// Queries have no partial result worth keeping, so callers stop right there.
+void scratchOutOfMemory(const char *what);
+
+#endif
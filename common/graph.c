@@ -0,0 +1,416 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+
+// Round a byte count up to the next multiple of 8
+static size_t align8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+// Byte sizes of the three CSR arrays (each section padded to 8 bytes)
+static void sectionSizes(int64_t numNodes, int64_t numArcs, uint32_t flags,
+                         size_t *offBytes, size_t *tgtBytes, size_t *wgtBytes) {
+    *offBytes = (size_t)(numNodes + 1) * sizeof(int64_t);
+    *tgtBytes = align8((size_t)numArcs * sizeof(int32_t));
+    *wgtBytes = (flags & GRAPH_WEIGHTED) ? align8((size_t)numArcs * sizeof(int32_t)) : 0;
+}
+
+int graphBuild(CsrGraph *g, int numNodes, const Edge *edges, int64_t numEdges, uint32_t flags) {
+    memset(g, 0, sizeof(*g));
+    if (numNodes <= 0 || numEdges < 0) {
+        fprintf(stderr, "graphBuild: invalid graph size\n");
+        return -1;
+    }
+
+    int undirected = (flags & GRAPH_UNDIRECTED) != 0;
+    int64_t numArcs = undirected ? 2 * numEdges : numEdges;
+
+    for (int64_t e = 0; e < numEdges; e++) {
+        if (edges[e].src < 0 || edges[e].src >= numNodes ||
+            edges[e].dest < 0 || edges[e].dest >= numNodes) {
+            fprintf(stderr, "graphBuild: edge %lld has an out-of-range endpoint\n", (long long)e);
+            return -1;
+        }
+    }
+
+    size_t offBytes, tgtBytes, wgtBytes;
+    sectionSizes(numNodes, numArcs, flags, &offBytes, &tgtBytes, &wgtBytes);
+
+    char *block = malloc(offBytes + tgtBytes + wgtBytes);
+    int64_t *offsets = (int64_t *)block;
+    int32_t *targets = (int32_t *)(block + offBytes);
+    int32_t *weights = wgtBytes ? (int32_t *)(block + offBytes + tgtBytes) : NULL;
+
+    // Scratch for the first pass: arcs bucketed by destination
+    int64_t *count = calloc((size_t)numNodes + 1, sizeof(int64_t));
+    int32_t *tmpSrc = malloc((size_t)numArcs * sizeof(int32_t) + 1);
+    int32_t *tmpDst = malloc((size_t)numArcs * sizeof(int32_t) + 1);
+    int32_t *tmpW = malloc((size_t)numArcs * sizeof(int32_t) + 1);
+    if (!block || !count || !tmpSrc || !tmpDst || !tmpW) {
+        fprintf(stderr, "graphBuild: out of memory\n");
+        free(block); free(count); free(tmpSrc); free(tmpDst); free(tmpW);
+        return -1;
+    }
+
+    // 1. Counting sort by destination
+    for (int64_t e = 0; e < numEdges; e++) {
+        count[edges[e].dest + 1]++;
+        if (undirected) count[edges[e].src + 1]++;
+    }
+    for (int v = 0; v < numNodes; v++) count[v + 1] += count[v];
+    for (int64_t e = 0; e < numEdges; e++) {
+        int64_t k = count[edges[e].dest]++;
+        tmpSrc[k] = edges[e].src;
+        tmpDst[k] = edges[e].dest;
+        tmpW[k] = edges[e].weight;
+        if (undirected) {
+            k = count[edges[e].src]++;
+            tmpSrc[k] = edges[e].dest;
+            tmpDst[k] = edges[e].src;
+            tmpW[k] = edges[e].weight;
+        }
+    }
+
+    // 2. Stable counting sort by source -> every row ends up sorted by target
+    memset(offsets, 0, offBytes);
+    for (int64_t k = 0; k < numArcs; k++) offsets[tmpSrc[k] + 1]++;
+    for (int v = 0; v < numNodes; v++) offsets[v + 1] += offsets[v];
+    memcpy(count, offsets, (size_t)numNodes * sizeof(int64_t));
+    for (int64_t k = 0; k < numArcs; k++) {
+        int64_t slot = count[tmpSrc[k]]++;
+        targets[slot] = tmpDst[k];
+        if (weights) weights[slot] = tmpW[k];
+    }
+
+    free(count);
+    free(tmpSrc);
+    free(tmpDst);
+    free(tmpW);
+
+    g->numNodes = numNodes;
+    g->numArcs = numArcs;
+    g->flags = flags & (GRAPH_WEIGHTED | GRAPH_UNDIRECTED);
+    g->offsets = offsets;
+    g->targets = targets;
+    g->weights = weights;
+    g->heapBlock = block;
+    return 0;
+}
+
+int graphLoadBinary(CsrGraph *g, const char *path) {
+    memset(g, 0, sizeof(*g));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(GraphFileHeader)) {
+        fprintf(stderr, "%s: not a binary graph file\n", path);
+        close(fd);
+        return -1;
+    }
+
+    size_t length = (size_t)st.st_size;
+    char *base = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        perror(path);
+        return -1;
+    }
+
+    const GraphFileHeader *h = (const GraphFileHeader *)base;
+    if (memcmp(h->magic, GRAPH_FILE_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != GRAPH_FILE_VERSION ||
+        h->numNodes == 0 || h->numNodes > INT_MAX) {
+        fprintf(stderr, "%s: unsupported graph file header\n", path);
+        munmap(base, length);
+        return -1;
+    }
+
+    // Bound numArcs by the file size before any size arithmetic, so a crafted
+    // header cannot wrap the section sizes around and pass the length check
+    if (h->numArcs > SIZE_MAX / sizeof(int32_t) ||
+        h->numArcs > (length - sizeof(GraphFileHeader)) / sizeof(int32_t)) {
+        fprintf(stderr, "%s: arc count does not match file size\n", path);
+        munmap(base, length);
+        return -1;
+    }
+
+    size_t offBytes, tgtBytes, wgtBytes;
+    sectionSizes((int64_t)h->numNodes, (int64_t)h->numArcs, h->flags, &offBytes, &tgtBytes, &wgtBytes);
+    if (length != sizeof(GraphFileHeader) + offBytes + tgtBytes + wgtBytes) {
+        fprintf(stderr, "%s: file size does not match header\n", path);
+        munmap(base, length);
+        return -1;
+    }
+
+    const char *data = base + sizeof(GraphFileHeader);
+    g->numNodes = (int)h->numNodes;
+    g->numArcs = (int64_t)h->numArcs;
+    g->flags = h->flags;
+    g->offsets = (const int64_t *)data;
+    g->targets = (const int32_t *)(data + offBytes);
+    g->weights = wgtBytes ? (const int32_t *)(data + offBytes + tgtBytes) : NULL;
+    g->mapBase = base;
+    g->mapLength = length;
+
+    // The validation sweep reads front to back; afterwards the access pattern
+    // is the caller's (BFS and Dijkstra jump around), so drop the hint again
+    madvise(base, length, MADV_SEQUENTIAL);
+    int rc = graphValidate(g, path);
+    madvise(base, length, MADV_NORMAL);
+    if (rc != 0) {
+        graphFree(g);
+        return -1;
+    }
+    return 0;
+}
+
+void graphAdviseSequential(const CsrGraph *g) {
+    if (g->mapBase) madvise(g->mapBase, g->mapLength, MADV_SEQUENTIAL);
+}
+
+int graphValidate(const CsrGraph *g, const char *label) {
+    if (g->offsets[0] != 0 || g->offsets[g->numNodes] != g->numArcs) {
+        fprintf(stderr, "%s: corrupt offset table\n", label);
+        return -1;
+    }
+    for (int u = 0; u < g->numNodes; u++) {
+        if (g->offsets[u + 1] < g->offsets[u]) {
+            fprintf(stderr, "%s: offsets of node %d are decreasing\n", label, u);
+            return -1;
+        }
+    }
+    for (int64_t k = 0; k < g->numArcs; k++) {
+        if (g->targets[k] < 0 || g->targets[k] >= g->numNodes) {
+            fprintf(stderr, "%s: arc %lld has an out-of-range target\n", label, (long long)k);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int graphSaveBinary(const CsrGraph *g, const char *path) {
+    FILE *fp = fopen(path, "wb");
+    if (!fp) {
+        perror(path);
+        return -1;
+    }
+
+    GraphFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, GRAPH_FILE_MAGIC, sizeof(h.magic));
+    h.version = GRAPH_FILE_VERSION;
+    h.flags = g->weights ? g->flags : (g->flags & ~GRAPH_WEIGHTED);
+    h.numNodes = (uint64_t)g->numNodes;
+    h.numArcs = (uint64_t)g->numArcs;
+
+    size_t offBytes, tgtBytes, wgtBytes;
+    sectionSizes(g->numNodes, g->numArcs, h.flags, &offBytes, &tgtBytes, &wgtBytes);
+    size_t arcBytes = (size_t)g->numArcs * sizeof(int32_t);
+    static const char zeros[8] = {0};
+
+    int ok = fwrite(&h, sizeof(h), 1, fp) == 1 &&
+             fwrite(g->offsets, 1, offBytes, fp) == offBytes &&
+             fwrite(g->targets, 1, arcBytes, fp) == arcBytes &&
+             fwrite(zeros, 1, tgtBytes - arcBytes, fp) == tgtBytes - arcBytes;
+    if (ok && wgtBytes) {
+        ok = fwrite(g->weights, 1, arcBytes, fp) == arcBytes &&
+             fwrite(zeros, 1, wgtBytes - arcBytes, fp) == wgtBytes - arcBytes;
+    }
+
+    if (fclose(fp) != 0) ok = 0;
+    if (!ok) {
+        fprintf(stderr, "%s: write failed\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// Parse an optionally signed decimal integer that fits in an int; advances *p.
+// Returns 0 if there are no digits, the value overflows, or the number runs
+// straight into other characters ("5abc").
+static int parseInt(const char **p, const char *end, long long *out) {
+    const char *s = *p;
+    int negative = 0;
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        s++;
+    }
+    if (s >= end || *s < '0' || *s > '9') return 0;
+
+    long long limit = negative ? -(long long)INT_MIN : INT_MAX;
+    long long value = 0;
+    while (s < end && *s >= '0' && *s <= '9') {
+        value = value * 10 + (*s - '0');
+        if (value > limit) return 0;
+        s++;
+    }
+    if (s < end && *s != ' ' && *s != '\t' && *s != '\r' && *s != '\n' && *s != '#' && *s != '%')
+        return 0;
+    *out = negative ? -value : value;
+    *p = s;
+    return 1;
+}
+
+// Skip spaces and tabs (but not newlines)
+static const char *skipBlanks(const char *s, const char *end) {
+    while (s < end && (*s == ' ' || *s == '\t' || *s == '\r')) s++;
+    return s;
+}
+
+int graphLoadEdgeList(CsrGraph *g, const char *path, uint32_t flags) {
+    memset(g, 0, sizeof(*g));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        fprintf(stderr, "%s: empty edge list\n", path);
+        close(fd);
+        return -1;
+    }
+
+    size_t length = (size_t)st.st_size;
+    const char *text = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (text == MAP_FAILED) {
+        perror(path);
+        return -1;
+    }
+    madvise((void *)text, length, MADV_SEQUENTIAL);
+
+    int64_t capacity = 1024, numEdges = 0;
+    Edge *edges = malloc((size_t)capacity * sizeof(Edge));
+    long long maxId = -1;
+    int lineNo = 0, failed = 0;
+
+    const char *p = text, *end = text + length;
+    while (p < end && !failed && edges) {
+        lineNo++;
+        p = skipBlanks(p, end);
+
+        if (p < end && *p != '\n' && *p != '#' && *p != '%') {
+            long long u, v, w = 1;
+            if (!parseInt(&p, end, &u)) {
+                failed = 1;
+                break;
+            }
+            p = skipBlanks(p, end);
+            if (!parseInt(&p, end, &v)) {
+                failed = 1;
+                break;
+            }
+            p = skipBlanks(p, end);
+            // Optional weight column; anything else there is an error, not a default
+            if (p < end && *p != '\n' && *p != '#' && *p != '%' && !parseInt(&p, end, &w)) {
+                failed = 1;
+                break;
+            }
+
+            if (u < 0 || v < 0 || u >= INT_MAX || v >= INT_MAX || w < INT_MIN || w > INT_MAX) {
+                failed = 1;
+                break;
+            }
+
+            if (numEdges == capacity) {
+                capacity *= 2;
+                Edge *grown = realloc(edges, (size_t)capacity * sizeof(Edge));
+                if (!grown) {
+                    free(edges);
+                    edges = NULL;
+                    break;
+                }
+                edges = grown;
+            }
+            edges[numEdges].src = (int)u;
+            edges[numEdges].dest = (int)v;
+            edges[numEdges].weight = (int)w;
+            numEdges++;
+            if (u > maxId) maxId = u;
+            if (v > maxId) maxId = v;
+        }
+
+        // Drop the rest of the line (comments, extra columns)
+        const char *nl = memchr(p, '\n', (size_t)(end - p));
+        p = nl ? nl + 1 : end;
+    }
+    munmap((void *)text, length);
+
+    if (!edges) {
+        fprintf(stderr, "%s: out of memory\n", path);
+        return -1;
+    }
+    if (failed || maxId < 0) {
+        if (failed)
+            fprintf(stderr, "%s:%d: malformed edge\n", path, lineNo);
+        else
+            fprintf(stderr, "%s: no edges found\n", path);
+        free(edges);
+        return -1;
+    }
+
+    int rc = graphBuild(g, (int)(maxId + 1), edges, numEdges, flags);
+    free(edges);
+    return rc;
+}
+
+int graphLoad(CsrGraph *g, const char *path, uint32_t textFlags) {
+    char magic[sizeof(((GraphFileHeader *)0)->magic)] = {0};
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        perror(path);
+        return -1;
+    }
+    size_t got = fread(magic, 1, sizeof(magic), fp);
+    fclose(fp);
+
+    if (got == sizeof(magic) && memcmp(magic, GRAPH_FILE_MAGIC, sizeof(magic)) == 0)
+        return graphLoadBinary(g, path);
+    return graphLoadEdgeList(g, path, textFlags);
+}
+
+void graphFree(CsrGraph *g) {
+    if (g->mapBase) munmap(g->mapBase, g->mapLength);
+    free(g->heapBlock);
+    memset(g, 0, sizeof(*g));
+}
+
+void graphNodeName(const CsrGraph *g, int index, char *buffer, size_t size) {
+    if (index < 0 || index >= g->numNodes)
+        snprintf(buffer, size, "?");
+    else if (g->numNodes <= 26)
+        snprintf(buffer, size, "%c", 'A' + index);
+    else
+        snprintf(buffer, size, "%d", index);
+}
+
+int graphParseNode(const CsrGraph *g, const char *text) {
+    int index = -1;
+    char c = text[0];
+    if (c >= 'a' && c <= 'z') c -= 32; // Handle lowercase
+
+    if (g->numNodes <= 26 && c >= 'A' && c <= 'Z' && text[1] == '\0') {
+        index = c - 'A';
+    } else {
+        // Numeric index works for every graph size
+        char *end;
+        long value = strtol(text, &end, 10);
+        if (end != text && *end == '\0' && value >= 0 && value <= INT_MAX) index = (int)value;
+    }
+    return (index >= 0 && index < g->numNodes) ? index : -1;
+}
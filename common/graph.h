@@ -0,0 +1,96 @@
+#ifndef DSA_GRAPH_H
+#define DSA_GRAPH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Shared graph core used by Q3 (Kruskal), Q4 (BFS) and Q5 (Bellman-Ford).
+//
+// Graphs are stored in Compressed Sparse Row (CSR) form:
+//   offsets[u] .. offsets[u + 1] - 1  are the arc slots of node u
+//   targets[k]                        is the destination of arc k
+//   weights[k]                        is the weight of arc k (NULL if unweighted)
+// Undirected graphs store every edge as two arcs (u -> v and v -> u).
+// Each row is sorted by target, so neighbours are visited in index order.
+
+#define GRAPH_WEIGHTED   0x1u
+#define GRAPH_UNDIRECTED 0x2u
+
+// Edge Structure (input to the builder)
+typedef struct {
+    int src, dest, weight;
+} Edge;
+
+// CSR Graph Structure
+typedef struct {
+    int numNodes;
+    int64_t numArcs;
+    uint32_t flags;           // GRAPH_WEIGHTED | GRAPH_UNDIRECTED
+    const int64_t *offsets;   // numNodes + 1 entries
+    const int32_t *targets;   // numArcs entries
+    const int32_t *weights;   // numArcs entries, or NULL
+
+    // Backing storage: either one heap block or one read-only mapping
+    void *heapBlock;
+    void *mapBase;
+    size_t mapLength;
+} CsrGraph;
+
+// Binary on-disk layout (little-endian, every section 8-byte aligned):
+//   GraphFileHeader
+//   int64_t offsets[numNodes + 1]
+//   int32_t targets[numArcs]   (padded to 8 bytes)
+//   int32_t weights[numArcs]   (only if GRAPH_WEIGHTED)
+// The arrays are used in place straight out of the mapping.
+#define GRAPH_FILE_MAGIC   "DSACSR01"
+#define GRAPH_FILE_VERSION 1u
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t numNodes;
+    uint64_t numArcs;
+} GraphFileHeader;
+
+// Build a CSR graph from an edge list.
+// With GRAPH_UNDIRECTED every edge is inserted in both directions.
+// Returns 0 on success, -1 on failure.
+int graphBuild(CsrGraph *g, int numNodes, const Edge *edges, int64_t numEdges, uint32_t flags);
+
+// Map a binary graph file produced by graphSaveBinary (no parsing, no copying).
+// The mapped arrays are checked with graphValidate before use.
+int graphLoadBinary(CsrGraph *g, const char *path);
+
+// One linear sweep over the CSR arrays: offsets start at 0, never decrease and
+// end at numArcs, and every target is in [0, numNodes). Prints the first
+// problem found (prefixed with `label`) and returns -1, or 0 if the graph is sound.
+int graphValidate(const CsrGraph *g, const char *label);
+
+// Hint that the caller will sweep the arrays front to back (Kruskal's gather,
+// Bellman-Ford passes). No-op for graphs that are not mapped from a file.
+void graphAdviseSequential(const CsrGraph *g);
+
+// Write a graph in the binary format above.
+int graphSaveBinary(const CsrGraph *g, const char *path);
+
+// Import a whitespace separated text edge list: "src dest [weight]" per line.
+// Lines starting with '#' or '%' are comments. Node count is max id + 1.
+// Edges without a weight get weight 1 when the file is weighted.
+int graphLoadEdgeList(CsrGraph *g, const char *path, uint32_t flags);
+
+// Load a graph by file type: binary files are recognised by their magic,
+// anything else is parsed as a text edge list with the given flags.
+int graphLoad(CsrGraph *g, const char *path, uint32_t textFlags);
+
+// Release whatever storage backs the graph.
+void graphFree(CsrGraph *g);
+
+// Node label for printing: letters (A, B, ...) for small graphs, numbers otherwise.
+void graphNodeName(const CsrGraph *g, int index, char *buffer, size_t size);
+
+// Parse a node label typed by the user (letter for small graphs, or number).
+// Returns -1 if invalid.
+int graphParseNode(const CsrGraph *g, const char *text);
+
+#endif
@@ -0,0 +1,117 @@
+#include "instrument.h"
+
+#ifdef DSA_INSTRUMENT
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define INSTR_MAX_SLOTS 64
+
+// One named metric
+typedef struct {
+    int kind;
+    const char *name;
+    long long *series;  // INSTR_SERIES_KIND only
+    int length;
+    int capacity;
+} Slot;
+
+long long instrValues[INSTR_MAX_SLOTS];
+static Slot slots[INSTR_MAX_SLOTS];
+static int slotCount = 0;
+static const char *programName = "unknown";
+
+uint64_t instrNowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+int instrRegister(int kind, const char *name) {
+    // Several call sites may share one name (e.g. swaps in sift-up and sift-down)
+    for (int i = 0; i < slotCount; i++)
+        if (slots[i].kind == kind && strcmp(slots[i].name, name) == 0) return i;
+
+    // Sharing a slot would silently merge unrelated metrics: stop instead
+    if (slotCount == INSTR_MAX_SLOTS) {
+        fprintf(stderr, "instrument: more than %d metrics (at %s); raise INSTR_MAX_SLOTS\n",
+                INSTR_MAX_SLOTS, name);
+        abort();
+    }
+    slots[slotCount].kind = kind;
+    slots[slotCount].name = name;
+    return slotCount++;
+}
+
+void instrAppend(int slot, long long value) {
+    Slot *s = &slots[slot];
+    if (s->length == s->capacity) {
+        int capacity = s->capacity ? s->capacity * 2 : 64;
+        long long *grown = realloc(s->series, capacity * sizeof(long long));
+        if (!grown) {
+            fprintf(stderr, "instrument: out of memory recording %s\n", s->name);
+            abort();
+        }
+        s->series = grown;
+        s->capacity = capacity;
+    }
+    s->series[s->length++] = value;
+}
+
+// Print all metrics of one kind as a JSON object
+static void writeSection(FILE *fp, const char *title, int kind) {
+    int first = 1;
+    fprintf(fp, "  \"%s\": {", title);
+    for (int i = 0; i < slotCount; i++) {
+        if (slots[i].kind != kind) continue;
+        fprintf(fp, "%s\n    \"%s\": ", first ? "" : ",", slots[i].name);
+        first = 0;
+
+        if (kind == INSTR_SERIES_KIND) {
+            fprintf(fp, "[");
+            for (int j = 0; j < slots[i].length; j++)
+                fprintf(fp, "%s%lld", j ? ", " : "", slots[i].series[j]);
+            fprintf(fp, "]");
+        } else if (kind == INSTR_TIMER) {
+            fprintf(fp, "%.3f", instrValues[i] / 1e6);
+        } else {
+            fprintf(fp, "%lld", instrValues[i]);
+        }
+    }
+    fprintf(fp, "%s}", first ? "" : "\n  ");
+}
+
+static void writeReport(void) {
+    const char *path = getenv("DSA_INSTRUMENT_OUT");
+    FILE *fp = path ? fopen(path, "w") : stderr;
+    if (!fp) {
+        perror(path);
+        return;
+    }
+
+    fprintf(fp, "{\n  \"program\": \"%s\",\n", programName);
+    writeSection(fp, "counters", INSTR_COUNTER);
+    fprintf(fp, ",\n");
+    writeSection(fp, "maxima", INSTR_MAXIMUM);
+    fprintf(fp, ",\n");
+    writeSection(fp, "series", INSTR_SERIES_KIND);
+    fprintf(fp, ",\n");
+    writeSection(fp, "timers_ms", INSTR_TIMER);
+    fprintf(fp, "\n}\n");
+
+    if (fp != stderr) fclose(fp);
+}
+
+void instrInit(const char *program) {
+    programName = program;
+    atexit(writeReport);
+}
+
+#else
+
+// Keep the translation unit non-empty when instrumentation is compiled out
+typedef int instrDisabled;
+
+#endif
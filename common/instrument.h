@@ -0,0 +1,84 @@
+#ifndef DSA_INSTRUMENT_H
+#define DSA_INSTRUMENT_H
+
+// Compile-time instrumentation shared by Q1-Q5.
+//
+// Build with -DDSA_INSTRUMENT to enable. Without it every macro below expands
+// to nothing, so uninstrumented builds pay no cost at all.
+//
+// When enabled, a JSON report is written at exit to the file named by the
+// DSA_INSTRUMENT_OUT environment variable (stderr if unset):
+//   {"program": ..., "counters": {...}, "maxima": {...},
+//    "series": {...}, "timers_ms": {...}}
+//
+//   INSTR_INIT(program)          register the exit-time report (call in main)
+//   INSTR_COUNT(name, delta)     add delta to counter `name`
+//   INSTR_MAX(name, value)       keep the largest value seen for `name`
+//   INSTR_SERIES(name, value)    append value to series `name` (e.g. one per level)
+//   INSTR_TIMER_BEGIN(name)      start phase timer `name` (in the current scope)
+//   INSTR_TIMER_END(name)        stop it and accumulate the elapsed time
+//
+// Names are plain identifiers, e.g. INSTR_COUNT(heap_swaps, 1). At most
+// INSTR_MAX_SLOTS (instrument.c) distinct names; registering more aborts.
+
+#ifdef DSA_INSTRUMENT
+
+#include <stdint.h>
+
+enum {
+    INSTR_COUNTER,
+    INSTR_MAXIMUM,
+    INSTR_SERIES_KIND,
+    INSTR_TIMER
+};
+
+extern long long instrValues[];
+
+void instrInit(const char *program);
+int instrRegister(int kind, const char *name);
+void instrAppend(int slot, long long value);
+uint64_t instrNowNs(void);
+
+// Each call site looks its slot up once and caches it in a static
+#define INSTR_SLOT_(kind, name) \
+    static int instrSlot_ = -1; \
+    if (instrSlot_ < 0) instrSlot_ = instrRegister(kind, #name)
+
+#define INSTR_INIT(program) instrInit(program)
+
+#define INSTR_COUNT(name, delta) do { \
+    INSTR_SLOT_(INSTR_COUNTER, name); \
+    instrValues[instrSlot_] += (delta); \
+} while (0)
+
+#define INSTR_MAX(name, value) do { \
+    INSTR_SLOT_(INSTR_MAXIMUM, name); \
+    long long instrV_ = (value); \
+    if (instrV_ > instrValues[instrSlot_]) instrValues[instrSlot_] = instrV_; \
+} while (0)
+
+#define INSTR_SERIES(name, value) do { \
+    INSTR_SLOT_(INSTR_SERIES_KIND, name); \
+    instrAppend(instrSlot_, (value)); \
+} while (0)
+
+#define INSTR_TIMER_BEGIN(name) uint64_t instrStart_##name = instrNowNs()
+
+#define INSTR_TIMER_END(name) do { \
+    INSTR_SLOT_(INSTR_TIMER, name); \
+    instrValues[instrSlot_] += (long long)(instrNowNs() - instrStart_##name); \
+} while (0)
+
+#else
+
+// sizeof keeps bookkeeping variables "used" without evaluating anything
+#define INSTR_INIT(program)       ((void)0)
+#define INSTR_COUNT(name, delta)  ((void)sizeof(delta))
+#define INSTR_MAX(name, value)    ((void)sizeof(value))
+#define INSTR_SERIES(name, value) ((void)sizeof(value))
+#define INSTR_TIMER_BEGIN(name)   ((void)0)
+#define INSTR_TIMER_END(name)     ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,148 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "report.h"
+
+void reportOpen(ReportWriter *w, int fd) {
+    w->fd = fd;
+    w->failed = 0;
+    w->firstField = 1;
+    w->used = 0;
+}
+
+void reportFlush(ReportWriter *w) {
+    size_t done = 0;
+    while (done < w->used) {
+        ssize_t n = write(w->fd, w->buffer + done, w->used - done);
+        if (n <= 0) {
+            w->failed = 1;
+            break;
+        }
+        done += (size_t)n;
+    }
+    w->used = 0;
+}
+
+int reportClose(ReportWriter *w) {
+    reportFlush(w);
+    return w->failed ? -1 : 0;
+}
+
+// Make sure `n` more bytes fit into the buffer
+static char *reserve(ReportWriter *w, size_t n) {
+    if (w->used + n > REPORT_BUFFER_SIZE) reportFlush(w);
+    return w->buffer + w->used;
+}
+
+static void putBytes(ReportWriter *w, const char *s, size_t n) {
+    while (n > 0) {
+        size_t room = REPORT_BUFFER_SIZE - w->used;
+        if (room == 0) {
+            reportFlush(w);
+            room = REPORT_BUFFER_SIZE;
+        }
+        size_t chunk = n < room ? n : room;
+        memcpy(w->buffer + w->used, s, chunk);
+        w->used += chunk;
+        s += chunk;
+        n -= chunk;
+    }
+}
+
+static void putChar(ReportWriter *w, char c) {
+    *reserve(w, 1) = c;
+    w->used++;
+}
+
+// JSON string with the minimal escaping the format requires
+static void putQuoted(ReportWriter *w, const char *s) {
+    static const char hex[] = "0123456789abcdef";
+    putChar(w, '"');
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            putChar(w, '\\');
+            putChar(w, (char)c);
+        } else if (c < 0x20) {
+            char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+            putBytes(w, esc, sizeof(esc));
+        } else {
+            putChar(w, (char)c);
+        }
+    }
+    putChar(w, '"');
+}
+
+// Separator and key for the next field
+static void putKey(ReportWriter *w, const char *key) {
+    if (!w->firstField) putChar(w, ',');
+    w->firstField = 0;
+    putQuoted(w, key);
+    putChar(w, ':');
+}
+
+void reportBegin(ReportWriter *w, const char *type) {
+    putChar(w, '{');
+    w->firstField = 1;
+    putKey(w, "type");
+    putQuoted(w, type);
+}
+
+void reportInt(ReportWriter *w, const char *key, long long value) {
+    putKey(w, key);
+
+    // Format right to left into a small scratch buffer
+    char digits[24];
+    int pos = sizeof(digits);
+    unsigned long long v = value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value;
+    do {
+        digits[--pos] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0) digits[--pos] = '-';
+    putBytes(w, digits + pos, sizeof(digits) - pos);
+}
+
+void reportString(ReportWriter *w, const char *key, const char *value) {
+    putKey(w, key);
+    putQuoted(w, value);
+}
+
+void reportBool(ReportWriter *w, const char *key, int value) {
+    putKey(w, key);
+    if (value)
+        putBytes(w, "true", 4);
+    else
+        putBytes(w, "false", 5);
+}
+
+void reportNull(ReportWriter *w, const char *key) {
+    putKey(w, key);
+    putBytes(w, "null", 4);
+}
+
+void reportEnd(ReportWriter *w) {
+    putBytes(w, "}\n", 2);
+}
+
+void reportMessage(ReportWriter *w, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vfprintf(w ? stderr : stdout, format, args);
+    va_end(args);
+}
+
+int reportTakeQuietFlag(int *argc, char *argv[]) {
+    int quiet = 0, kept = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0)
+            quiet = 1;
+        else
+            argv[kept++] = argv[i];
+    }
+    *argc = kept;
+    argv[kept] = NULL;
+    return quiet;
+}
@@ -0,0 +1,46 @@
+#ifndef DSA_REPORT_H
+#define DSA_REPORT_H
+
+#include <stddef.h>
+
+// Buffered JSON-lines writer for quiet/batch mode (-q).
+//
+// In quiet mode the programs drop all per-step narrative and emit only their
+// final results, one JSON object per line:
+//   {"type":"mst_edge","src":1,"dest":3,"weight":5}
+// Records are formatted by hand into a fixed buffer and written with write(2)
+// in large chunks, so output runs at I/O speed instead of printf speed.
+
+#define REPORT_BUFFER_SIZE (1 << 16)
+
+typedef struct {
+    int fd;
+    int failed;
+    int firstField;
+    size_t used;
+    char buffer[REPORT_BUFFER_SIZE];
+} ReportWriter;
+
+void reportOpen(ReportWriter *w, int fd);
+// Flush pending output; returns 0 on success, -1 if any write failed.
+int reportClose(ReportWriter *w);
+void reportFlush(ReportWriter *w);
+
+// One record: reportBegin, any number of fields, reportEnd
+void reportBegin(ReportWriter *w, const char *type);
+void reportInt(ReportWriter *w, const char *key, long long value);
+void reportString(ReportWriter *w, const char *key, const char *value);
+void reportBool(ReportWriter *w, const char *key, int value);
+void reportNull(ReportWriter *w, const char *key);
+void reportEnd(ReportWriter *w);
+
+// Plain-text message (errors, warnings) that is not part of the results:
+// printed to stdout when w is NULL (narrative mode), to stderr in quiet mode,
+// so it never lands in the middle of the JSON-lines stream.
+void reportMessage(ReportWriter *w, const char *format, ...);
+
+// Remove "-q" / "--quiet" from argv (shifting the rest down).
+// Returns 1 if the flag was present.
+int reportTakeQuietFlag(int *argc, char *argv[]);
+
+#endif
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "workload.h"
+
+int loadPriorityStream(const char *path, int **values, int *count) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        perror(path);
+        return -1;
+    }
+
+    // Read the whole file at once; parsing from memory beats fscanf by far
+    fseek(fp, 0, SEEK_END);
+    long length = ftell(fp);
+    rewind(fp);
+    char *text = malloc((size_t)length + 1);
+    if (!text || fread(text, 1, (size_t)length, fp) != (size_t)length) {
+        fprintf(stderr, "%s: read failed\n", path);
+        free(text);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    text[length] = '\0';
+
+    int capacity = 1024, n = 0, lineNo = 1, failed = 0;
+    int *out = malloc(capacity * sizeof(int));
+    char *p = text;
+
+    while (out && *p) {
+        if (*p == '\n') lineNo++;
+        if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+            p++;
+            continue;
+        }
+        if (*p == '#') {
+            while (*p && *p != '\n') p++;
+            continue;
+        }
+
+        // Anything else must be a whole number in range; INT_MAX is kept free so
+        // the programs can always insert a job that outranks the whole stream
+        char *end;
+        long v = strtol(p, &end, 10);
+        if (end == p || v < INT_MIN || v >= INT_MAX ||
+            (*end && *end != ' ' && *end != '\t' && *end != '\r' && *end != '\n' && *end != '#')) {
+            failed = 1;
+            break;
+        }
+        p = end;
+
+        if (n == capacity) {
+            capacity *= 2;
+            int *grown = realloc(out, capacity * sizeof(int));
+            if (!grown) {
+                free(out);
+                out = NULL;
+                break;
+            }
+            out = grown;
+        }
+        out[n++] = (int)v;
+    }
+    free(text);
+
+    if (!out) {
+        fprintf(stderr, "%s: out of memory\n", path);
+        return -1;
+    }
+    if (failed) {
+        fprintf(stderr, "%s:%d: malformed priority\n", path, lineNo);
+        free(out);
+        return -1;
+    }
+    *values = out;
+    *count = n;
+    return 0;
+}
@@ -0,0 +1,13 @@
+#ifndef DSA_WORKLOAD_H
+#define DSA_WORKLOAD_H
+
+// Priority stream input for the heap programs (Q1, Q2).
+// A stream file is plain text: whitespace separated integers, one priority each,
+// in [INT_MIN, INT_MAX - 1]. '#' starts a comment that runs to the end of the line.
+
+// Load every priority from the file into a newly allocated array.
+// Returns 0 on success (caller frees *values), -1 on failure; anything that is
+// not a priority (words, out-of-range numbers) is reported as path:line and fails.
+int loadPriorityStream(const char *path, int **values, int *count);
+
+#endif
@@ -0,0 +1,48 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Allocation counter, loaded with LD_PRELOAD by tests/check_allocs.sh.
+//
+// Interposes malloc, calloc and realloc (every path through which a program
+// or libc can ask the system allocator for memory) and forwards them to
+// glibc. At exit the total is written to the file named by DSA_ALLOC_OUT
+// (stderr if unset), so runs with different --repeat counts can be compared.
+//
+// Build: gcc -O2 -shared -fPIC tests/alloccount.c -o alloccount.so
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static long long allocCount = 0;
+
+void *malloc(size_t size) {
+    __atomic_add_fetch(&allocCount, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    __atomic_add_fetch(&allocCount, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    __atomic_add_fetch(&allocCount, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(ptr, size);
+}
+
+// Runs after main returns or exit() is called; avoids stdio, which allocates
+__attribute__((destructor)) static void writeCount(void) {
+    char line[32];
+    int length = snprintf(line, sizeof(line), "%lld\n", allocCount);
+    const char *path = getenv("DSA_ALLOC_OUT");
+    int fd = path ? open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644) : STDERR_FILENO;
+    if (fd < 0) return;
+    // Nothing sensible to do on a short write this late; a missing count fails the check
+    ssize_t written = write(fd, line, (size_t)length);
+    (void)written;
+    if (fd != STDERR_FILENO) close(fd);
+}
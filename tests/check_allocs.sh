@@ -0,0 +1,64 @@
+#!/bin/sh
+# Steady-state allocation check for the per-query hot paths (Q2-Q5).
+#
+# Runs each program once with --repeat 1 and once with --repeat N under the
+# malloc/calloc/realloc counter in tests/alloccount.c. Loading, the first query
+# and output buffers allocate the same amount either way, so the totals must be
+# equal: any difference means a query after the first allocated memory.
+#
+# Usage (from the repository root, after building everything):
+#   sh tests/check_allocs.sh [N]      # N defaults to 5
+# Exits 0 if every program passes, 1 otherwise.
+
+REPEAT=${1:-5}
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+gcc -O2 -shared -fPIC tests/alloccount.c -o "$WORK/alloccount.so" || exit 1
+bench/bench gen prio 4096 "$WORK/prio.txt" 7 > /dev/null || exit 1
+bench/bench gen rmat 4096 "$WORK/graph.bin" 7 > /dev/null || exit 1
+echo 0 > "$WORK/start.txt"
+: > "$WORK/empty.txt"
+
+failed=0
+
+# allocs <stdin> <program> <args...>: print the allocation total of one run
+allocs() {
+    input=$1
+    shift
+    rm -f "$WORK/count"
+    if ! DSA_ALLOC_OUT="$WORK/count" LD_PRELOAD="$WORK/alloccount.so" \
+            "$@" < "$input" > /dev/null; then
+        echo "error"
+        return
+    fi
+    cat "$WORK/count" 2> /dev/null || echo "error"
+}
+
+# check <label> <stdin> <program> <args...>
+check() {
+    label=$1
+    input=$2
+    program=$3
+    shift 3
+    one=$(allocs "$input" "$program" -q --repeat 1 "$@")
+    many=$(allocs "$input" "$program" -q --repeat "$REPEAT" "$@")
+    if [ "$one" != "error" ] && [ "$one" = "$many" ]; then
+        echo "PASS $label: $one allocations for 1 and $REPEAT queries"
+    else
+        echo "FAIL $label: $one allocations for 1 query, $many for $REPEAT"
+        failed=1
+    fi
+}
+
+check "Q2 built-in"       "$WORK/empty.txt" Q2/question2
+check "Q2 priorities"     "$WORK/empty.txt" Q2/question2 "$WORK/prio.txt"
+check "Q3 built-in"       "$WORK/empty.txt" Q3/question3
+check "Q3 rmat"           "$WORK/empty.txt" Q3/question3 "$WORK/graph.bin"
+check "Q4 built-in"       "$WORK/start.txt" Q4/question4
+check "Q4 rmat"           "$WORK/start.txt" Q4/question4 "$WORK/graph.bin"
+check "Q4 rmat --within"  "$WORK/start.txt" Q4/question4 --within 5,20,50 "$WORK/graph.bin"
+check "Q5 built-in"       "$WORK/empty.txt" Q5/question5
+check "Q5 rmat"           "$WORK/empty.txt" Q5/question5 "$WORK/graph.bin"
+
+exit $failed